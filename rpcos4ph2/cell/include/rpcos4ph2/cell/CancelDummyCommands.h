@@ -0,0 +1,28 @@
+#ifndef __RPCOS4PH2_CELL_CANCELDUMMYCOMMANDS_H__
+#define __RPCOS4PH2_CELL_CANCELDUMMYCOMMANDS_H__
+
+
+#include "ts/framework/CellCommand.h"
+
+
+namespace rpcos4ph2
+{
+    namespace cell
+    {
+
+//! Cell command that cancels the dummy boards' configure commands that are scheduled or running, on one board (parameter
+//! "Board ID") or on all boards if that's empty; the cancelled commands stop at their next step, with an error
+class CancelDummyCommands : public tsframework::CellCommand {
+public:
+  CancelDummyCommands(log4cplus::Logger& aLogger, tsframework::CellAbstractContext* aContext);
+
+  ~CancelDummyCommands();
+
+  void code();
+};
+
+} // end ns: cell
+} // end ns: rpcos4ph2
+
+
+#endif /* __RPCOS4PH2_CELL_CANCELDUMMYCOMMANDS_H__ */
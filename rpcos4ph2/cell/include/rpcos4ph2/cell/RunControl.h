@@ -2,6 +2,8 @@
 #ifndef __RPCOS4PH2_CELL_RUNCONTROL_H__
 #define __RPCOS4PH2_CELL_RUNCONTROL_H__
 
+#include <string>
+
 #include "swatchcell/framework/RunControl.h"
 
 namespace rpcos4ph2
@@ -16,9 +18,40 @@ namespace rpcos4ph2
             ~RunControl();
 
         private:
+            void execPreColdReset();
+            void execPostColdReset();
+
+            void execPreSetup();
+            void execPostSetup();
+
+            void execPreConfigure();
+            void execPostConfigure();
+
+            void execPreAlign();
+            void execPostAlign();
+
+            void execPreStart();
             void execPostStart();
 
+            void execPrePause();
+            void execPostPause();
+
+            void execPreResume();
+            void execPostResume();
+
             void execPreStop();
+            void execPostStop();
+
+            //! Applies the dummy boards' settings from the gatekeeper (e.g. monitoring refresh periods), once the setup or configure
+            //! transition has engaged the configuration key
+            void engageDummySettings();
+
+            //! Reports the timing of the dummy boards' commands in the transition that has just finished, then discards them;
+            //! the timeline is also written to '<dummyTraceFile>.<transition>.json' if that gatekeeper parameter isn't empty
+            void reportTransitionTiming(const std::string &aTransitionId);
+
+            //! Returns the 'dummyTraceFile' gatekeeper parameter, or an empty string if there's none
+            std::string readTraceFile();
         };
 
     } // namespace cell
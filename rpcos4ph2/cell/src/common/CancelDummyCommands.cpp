@@ -0,0 +1,44 @@
+
+#include "rpcos4ph2/cell/CancelDummyCommands.h"
+
+
+#include "boost/lexical_cast.hpp"
+
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+#include "xdata/String.h"
+
+#include "rpcos4ph2/dummy/DummyCancelToken.hpp"
+
+
+namespace rpcos4ph2 {
+namespace cell {
+
+
+CancelDummyCommands::CancelDummyCommands(log4cplus::Logger& aLogger, tsframework::CellAbstractContext* aContext) :
+  tsframework::CellCommand(aLogger, aContext)
+{
+  getParamList()["Board ID"] = new xdata::String("");
+}
+
+
+CancelDummyCommands::~CancelDummyCommands()
+{
+}
+
+
+void CancelDummyCommands::code()
+{
+  const std::string lBoardId = getParamList()["Board ID"]->toString();
+  const size_t lNumCancelled = rpcos4ph2::dummy::DummyCancelToken::cancelActive(lBoardId);
+
+  const std::string lMessage = "Cancelled " + boost::lexical_cast<std::string>(lNumCancelled) + " dummy command(s) "
+      + (lBoardId.empty() ? std::string("on all boards") : "on board '" + lBoardId + "'");
+  LOG4CPLUS_INFO(getLogger(), lMessage);
+  payload_->fromString(lMessage);
+}
+
+
+} // end ns: cell
+} // end ns: rpcos4ph2
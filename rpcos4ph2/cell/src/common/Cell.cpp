@@ -2,12 +2,14 @@
 
 #include "swatch/action/ThreadPool.hpp"
 
+#include "ts/framework/CellCommandFactory.h"
 #include "ts/framework/CellPanelFactory.h"
 
 #include "swatchcell/framework/ExplorePanel.h"
 #include "swatchcell/framework/RedirectPanel.h"
 #include "swatchcell/framework/RunControl.h"
 
+#include "rpcos4ph2/cell/CancelDummyCommands.h"
 #include "rpcos4ph2/cell/CellContext.h"
 #include "rpcos4ph2/cell/RunControl.h"
 
@@ -33,6 +35,9 @@ namespace rpcos4ph2
             tsframework::CellPanelFactory *lPanelFactory = getContext()->getPanelFactory();
             lPanelFactory->add<swatchcellframework::ExplorePanel>("SWATCH Explorer");
             lPanelFactory->add<swatchcellframework::RedirectPanel>("Home");
+
+            // Cancels the dummy boards' configure commands, e.g. to abort a long transition
+            getContext()->getCommandFactory()->add<CancelDummyCommands>("CancelDummyCommands");
         }
 
     } // namespace cell
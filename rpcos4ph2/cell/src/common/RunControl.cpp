@@ -2,9 +2,20 @@
 #include "rpcos4ph2/cell/RunControl.h"
 
 
+#include <fstream>
+#include <sstream>
+
 #include "log4cplus/logger.h"
 #include "log4cplus/loggingmacros.h"
 
+#include "swatch/action/GateKeeper.hpp"
+#include "swatch/system/System.hpp"
+#include "xdata/String.h"
+#include "swatchcell/framework/CellContext.h"
+
+#include "rpcos4ph2/dummy/DummySystem.hpp"
+#include "rpcos4ph2/dummy/DummyTransitionProfiler.hpp"
+
 
 
 namespace rpcos4ph2 {
@@ -24,15 +35,166 @@ RunControl::~RunControl()
 }
 
 
+void RunControl::execPreColdReset()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("coldReset");
+}
+
+
+void RunControl::execPostColdReset()
+{
+  reportTransitionTiming("coldReset");
+}
+
+
+void RunControl::execPreSetup()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("setup");
+}
+
+
+void RunControl::execPostSetup()
+{
+  engageDummySettings();
+  reportTransitionTiming("setup");
+}
+
+
+void RunControl::execPreConfigure()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("configure");
+}
+
+
+void RunControl::execPostConfigure()
+{
+  engageDummySettings();
+  reportTransitionTiming("configure");
+}
+
+
+void RunControl::execPreAlign()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("align");
+}
+
+
+void RunControl::execPostAlign()
+{
+  reportTransitionTiming("align");
+}
+
+
+void RunControl::execPreStart()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("start");
+}
+
+
 void RunControl::execPostStart()
 {
   LOG4CPLUS_INFO(getLogger(), "swatchcellexample::RunControl : execPostStart");
+  reportTransitionTiming("start");
+}
+
+
+void RunControl::execPrePause()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("pause");
+}
+
+
+void RunControl::execPostPause()
+{
+  reportTransitionTiming("pause");
+}
+
+
+void RunControl::execPreResume()
+{
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("resume");
+}
+
+
+void RunControl::execPostResume()
+{
+  reportTransitionTiming("resume");
 }
 
 
 void RunControl::execPreStop()
 {
   LOG4CPLUS_INFO(getLogger(), "swatchcellexample::RunControl : execPreStop");
+  rpcos4ph2::dummy::DummyTransitionProfiler::get().beginTransition("stop");
+}
+
+
+void RunControl::execPostStop()
+{
+  reportTransitionTiming("stop");
+}
+
+
+void RunControl::engageDummySettings()
+{
+  swatchcellframework::CellContext& lContext = dynamic_cast<swatchcellframework::CellContext&>(*getContext());
+  swatchcellframework::CellContext::SharedGuard lGuard(lContext);
+
+  const swatch::action::GateKeeper* lGateKeeper = lContext.getGateKeeper(lGuard);
+  rpcos4ph2::dummy::DummySystem* lSystem = dynamic_cast<rpcos4ph2::dummy::DummySystem*>(&lContext.getSystem(lGuard));
+  if ((lGateKeeper == NULL) || (lSystem == NULL)) {
+    LOG4CPLUS_WARN(getLogger(), "No gatekeeper or no dummy system; settings of the dummy boards are unchanged");
+    return;
+  }
+
+  lSystem->engage(*lGateKeeper);
+}
+
+
+std::string RunControl::readTraceFile()
+{
+  swatchcellframework::CellContext& lContext = dynamic_cast<swatchcellframework::CellContext&>(*getContext());
+  swatchcellframework::CellContext::SharedGuard lGuard(lContext);
+
+  // No gatekeeper before the first setup (e.g. in cold reset), so no timeline either
+  const swatch::action::GateKeeper* lGateKeeper = lContext.getGateKeeper(lGuard);
+  if (lGateKeeper == NULL)
+    return "";
+
+  const swatch::action::GateKeeper::Parameter_t lParam = lGateKeeper->get("", "", "dummyTraceFile", lContext.getSystem(lGuard).getGateKeeperContexts());
+  if (!lParam)
+    return "";
+
+  const xdata::String* lFileName = dynamic_cast<const xdata::String*>(lParam.get());
+  if (lFileName == NULL) {
+    LOG4CPLUS_WARN(getLogger(), "Parameter 'dummyTraceFile' isn't a string; no timeline written");
+    return "";
+  }
+  return lFileName->value_;
+}
+
+
+void RunControl::reportTransitionTiming(const std::string& aTransitionId)
+{
+  // Records of an earlier transition that failed (so wasn't reported) are included, under their own transition
+  rpcos4ph2::dummy::DummyTransitionProfiler& lProfiler = rpcos4ph2::dummy::DummyTransitionProfiler::get();
+  lProfiler.beginTransition("");
+
+  std::ostringstream lSummary;
+  lProfiler.writeSummary(lSummary);
+  LOG4CPLUS_INFO(getLogger(), "Timing of transition '" << aTransitionId << "': " << lSummary.str());
+
+  const std::string lTraceFile = readTraceFile();
+  if (!lTraceFile.empty()) {
+    const std::string lFileName = lTraceFile + "." + aTransitionId + ".json";
+    std::ofstream lStream(lFileName.c_str());
+    lProfiler.writeChromeTrace(lStream);
+    if (lStream)
+      LOG4CPLUS_INFO(getLogger(), "Timeline of transition '" << aTransitionId << "' written to '" << lFileName << "'");
+    else
+      LOG4CPLUS_WARN(getLogger(), "Could not write timeline of transition '" << aTransitionId << "' to '" << lFileName << "'");
+  }
+  lProfiler.clear();
 }
 
 
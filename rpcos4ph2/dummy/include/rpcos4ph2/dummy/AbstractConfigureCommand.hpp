@@ -8,25 +8,142 @@
 #define _RPCOS4PH2_DUMMY_ABSTRACTCONFIGURECOMMAND_HPP__
 
 
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/chrono.hpp"
+#include "boost/function.hpp"
+#include "boost/shared_ptr.hpp"
+
 #include "swatch/action/Command.hpp"
 
+#include "rpcos4ph2/dummy/DummyCancelToken.hpp"
+
+
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
+
 
 namespace rpcos4ph2 {
 namespace dummy {
 
 
+/**
+ * @class AbstractConfigureCommand
+ * @brief Simulates a configuration step that takes 'cmdDuration' seconds, then runs the subclass's action
+ *
+ * The command's steps run as short tasks on the DummyStepScheduler: each step queues the next one for the time it's due,
+ * rather than sleeping on a thread, so that a small pool can drive the commands of many boards at once. The cancel token
+ * is checked at each step, and wakes up a waiting execution straight away.
+ */
 class AbstractConfigureCommand : public swatch::action::Command {
 public:
+  //! Outcome of an execution that's started outside of SWATCH's own execution of the command
+  struct Outcome {
+    Outcome();
+
+    State state;
+    //! Message of the error that the command would have thrown in SWATCH's execution of it; empty if none
+    std::string error;
+    //! Execution details, as strings
+    std::vector<std::pair<std::string, std::string> > details;
+    //! Register round-trips made by the execution
+    uint32_t roundTrips;
+  };
+
+  typedef boost::function<void (const Outcome&)> Callback_t;
+
   AbstractConfigureCommand(const std::string& aId, swatch::action::ActionableObject& aActionable);
   virtual ~AbstractConfigureCommand();
 
+  //! Token for cancelling the current (or scheduled) execution; checked between steps, and the command then stops with an error.
+  //! It's cleared as each execution ends
+  DummyCancelToken& getCancelToken();
+
+  //! Starts the command outside of SWATCH's own execution of it (e.g. as a branch of a DummyForkJoinCommand), and returns
+  //! straight away; aCallback is called on the step scheduler with the outcome once it has finished. Its execution details
+  //! are returned in the outcome rather than added to the command, and its status message & progress aren't updated,
+  //! since SWATCH owns those of the command
+  void start(const swatch::core::XParameterSet& aParams, const Callback_t& aCallback);
+
+  //! Adds the command's parameters to aParams, as resolved from the gatekeeper's entries for this command (i.e. those with
+  //! cmd="<command ID>", or with no command); parameters that aren't set there (or if aGateKeeper is NULL) get their defaults
+  void resolveParameters(const swatch::action::GateKeeper* aGateKeeper, const std::vector<std::string>& aContexts, swatch::core::XParameterSet& aParams) const;
+
+  //! Duration of each step of the simulated configuration
+  static const boost::chrono::milliseconds kStepDuration;
+
 protected:
+  //! Starts the execution, and waits for it to finish, since SWATCH expects its outcome on return
   State code(const swatch::core::XParameterSet& aParams);
 
   virtual void runAction(bool aErrorOccurs) = 0;
+
+  //! Adds the command's inputs other than its parameters (e.g. the port mask) to the hash of its configuration
+  virtual uint64_t hashInputs(uint64_t aHash);
+
+  //! Hash of the configuration currently applied to the part of the board that the command configures; by default 0
+  //! (i.e. unknown), so that the command is never skipped, as for reboots & processor resets
+  virtual uint64_t getAppliedConfiguration();
+
+  //! Hash of the configuration (parameters & other inputs) of the current execution, to record once it's applied
+  uint64_t getConfigurationHash() const;
+
+  static uint64_t addToHash(uint64_t aHash, const std::string& aValue);
+
+  static uint64_t addToHash(uint64_t aHash, uint64_t aValue);
+
+  //! Hides Command::addExecutionDetails, so that details are returned to the caller while running inline
+  template <class T>
+  void addExecutionDetails(const std::string& aId, const T& aValue);
+
+  //! Hide Command::setStatusMsg & setProgress, which do nothing while running inline
+  void setStatusMsg(const std::string& aMessage);
+
+  void setProgress(float aProgress);
+
+private:
+  //! State of the current execution, shared with its steps on the scheduler
+  struct Execution;
+
+  void start(const swatch::core::XParameterSet& aParams, bool aInline, const Callback_t& aCallback);
+
+  //! Starts the execution and waits for its outcome
+  Outcome run(const swatch::core::XParameterSet& aParams, bool aInline);
+
+  //! Runs the execution's current step, then queues the next one for when it's due; at the last step, runs the action.
+  //! Ends the execution instead if it has been cancelled
+  static void runStep(const boost::shared_ptr<Execution>& aExecution);
+
+  //! Ends the execution and passes its outcome to the callback; the execution's mutex must be locked by caller
+  static void finish(Execution& aExecution, State aState, const std::string& aError);
+
+  DummyCancelToken mCancelToken;
+  uint64_t mConfigurationHash;
+  //! While running inline, the execution's list of details; otherwise NULL
+  std::vector<std::pair<std::string, std::string> >* mInlineDetails;
+  //! Index of this command in the transition profiler
+  const uint32_t mProfilerIndex;
 };
 
 
+template <class T>
+void AbstractConfigureCommand::addExecutionDetails(const std::string& aId, const T& aValue)
+{
+  if (mInlineDetails == NULL)
+    swatch::action::Command::addExecutionDetails(aId, aValue);
+  else {
+    T lValue(aValue);
+    mInlineDetails->push_back(std::make_pair(aId, lValue.toString()));
+  }
+}
+
+
 } // end ns: dummy
 } // end ns: swatch
 
@@ -4,9 +4,15 @@
 
 
 #include <stdint.h>
+#include <atomic>
 #include <vector>
 
+#include "boost/optional.hpp"
+
 #include "rpcos4ph2/dummy/ComponentState.hpp"
+#include "rpcos4ph2/dummy/DummyAppliedConfiguration.hpp"
+#include "rpcos4ph2/dummy/DummyRegisterMap.hpp"
+#include "rpcos4ph2/dummy/DummyRegisterTransaction.hpp"
 
 
 namespace rpcos4ph2 {
@@ -22,6 +28,24 @@ public:
   struct SLinkStatus;
   struct AMCPortStatus;
 
+  //! Independently-readable blocks of the AMC13's status; the AMC backplane ports share a state register, so form one part
+  enum StatusBlockPart {
+    kTTCPart,
+    kEvbPart,
+    kSLinkPart,
+    kAMCPortsPart,
+    kNumStatusBlockParts
+  };
+
+  //! Parts of the AMC13 that are each configured by a separate command, whose last-applied configuration is tracked
+  enum ConfigurationPart {
+    kClockConfig,
+    kEvbConfig,
+    kSLinkConfig,
+    kAMCPortsConfig,
+    kNumConfigurationParts
+  };
+
   DummyAMC13Driver();
 
   ~DummyAMC13Driver();
@@ -36,6 +60,41 @@ public:
 
   AMCPortStatus readAMCPortStatus(uint32_t aSlotId) const;
 
+  // Variants of the above that don't throw; they return an empty optional if the block isn't reachable
+  boost::optional<TTCStatus> tryReadTTCStatus() const;
+
+  boost::optional<EventBuilderStatus> tryReadEvbStatus() const;
+
+  boost::optional<SLinkStatus> tryReadSLinkStatus() const;
+
+  boost::optional<AMCPortStatus> tryReadAMCPortStatus(uint32_t aSlotId) const;
+
+  //! Checks whether the AMC13 responds again (reads the FED ID, and the state of each block)
+  bool probe() const;
+
+  //! Checks whether one part of the AMC13 responds again (reads the FED ID, and the state of that part's block)
+  bool probe(StatusBlockPart aPart) const;
+
+  //! While suspended, status reads of the part report it as not reachable without accessing the registers
+  void setStatusPollingSuspended(StatusBlockPart aPart, bool aSuspended);
+
+  //! Number of status reads of a part's block (or ports) since construction, and how many of those found it not reachable
+  uint64_t getNumStatusReads(StatusBlockPart aPart) const;
+  uint64_t getNumFailedStatusReads(StatusBlockPart aPart) const;
+
+  //! Number of configuration transactions committed since construction, i.e. changes to the state of the AMC13
+  uint64_t getNumCommits() const;
+
+  //! Hash of the configuration last applied to a part of the AMC13; 0 if there's none, or if the part's state has since changed
+  uint64_t getAppliedConfiguration(ConfigurationPart aPart) const;
+
+  //! Records the hash of the configuration that's just been applied to a part of the AMC13, along with its current state
+  void setAppliedConfiguration(ConfigurationPart aPart, uint64_t aHash);
+
+  //! If enabled, configuration writes are read back (in a second round-trip) to check them
+  void setWriteVerification(bool aVerify);
+
+  // Each of the following stages its register writes, and sends them to the AMC13 in a single round-trip
   void reboot();
 
   void reset();
@@ -58,17 +117,37 @@ public:
 
   void stopDaq();
 
+  //! Simulated register space of the AMC13, e.g. for benchmarking access patterns
+  DummyRegisterMap& getRegisterMap();
+
 private:
+  // Emulate the firmware: update the state register of each block, along with the status registers derived from it;
+  // the writes are staged in the transaction, until it's committed
+  void setClkTtcState(ComponentState aNewState);
+  void setEvbState(ComponentState aNewState);
+  void setSLinkState(ComponentState aNewState);
+  void setAMCPortState(ComponentState aNewState);
+  void setRunning(bool aRunning);
+
+  void commit();
 
-  std::vector<uint8_t> mVec;
+  ComponentState readState(uint32_t aAddress) const;
 
-  ComponentState mClkTtcState;
-  ComponentState mEvbState;
-  ComponentState mSLinkState;
-  ComponentState mAMCPortState;
-  bool mRunning;
+  //! Current state of a configurable part
+  ComponentState readState(ConfigurationPart aPart) const;
 
-  uint16_t mFedId;
+  //! Counts a status read of a part in the given state; returns false if it's not reachable
+  bool recordStatusRead(StatusBlockPart aPart, ComponentState aState) const;
+
+  DummyRegisterMap mRegisters;
+  DummyRegisterTransaction mTransaction;
+  bool mVerifyWrites;
+  DummyAppliedConfiguration mAppliedConfiguration;
+
+  std::atomic<bool> mStatusPollingSuspended[kNumStatusBlockParts];
+  mutable std::atomic<uint64_t> mNumStatusReads[kNumStatusBlockParts];
+  mutable std::atomic<uint64_t> mNumFailedStatusReads[kNumStatusBlockParts];
+  std::atomic<uint64_t> mNumCommits;
 
 public:
   struct TTCStatus {
@@ -78,12 +157,16 @@ public:
     uint32_t errCountSingleBit;
     uint32_t errCountDoubleBit;
     bool warningSign;
+
+    bool operator==(const TTCStatus& aOther) const;
   };
 
   struct EventBuilderStatus {
     bool outOfSync;
     bool ttsWarning;
     uint64_t l1aCount;
+
+    bool operator==(const EventBuilderStatus& aOther) const;
   };
 
   struct SLinkStatus {
@@ -91,12 +174,16 @@ public:
     bool backPressure;
     uint32_t wordsSent;
     uint32_t packetsSent;
+
+    bool operator==(const SLinkStatus& aOther) const;
   };
 
   struct AMCPortStatus {
     bool outOfSync;
     bool ttsWarning;
     uint64_t amcEventCount;
+
+    bool operator==(const AMCPortStatus& aOther) const;
   };
 
 };
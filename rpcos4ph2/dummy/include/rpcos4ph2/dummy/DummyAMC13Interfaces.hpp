@@ -2,6 +2,10 @@
 #ifndef _RPCOS4PH2_DUMMY_DUMMYAMC13INTERFACES_HPP__
 #define _RPCOS4PH2_DUMMY_DUMMYAMC13INTERFACES_HPP__
 
+#include "rpcos4ph2/dummy/DummyAMC13Driver.hpp"
+#include "rpcos4ph2/dummy/DummyAMC13StatusCache.hpp"
+#include "rpcos4ph2/dummy/DummyChangeTracker.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
 #include "swatch/dtm/AMCPort.hpp"
 #include "swatch/dtm/EVBInterface.hpp"
 #include "swatch/dtm/SLinkExpress.hpp"
@@ -12,70 +16,100 @@ namespace rpcos4ph2
     namespace dummy
     {
 
-        class DummyAMC13Driver;
-
         class AMC13BackplaneDaqPort : public swatch::dtm::AMCPort
         {
         public:
-            AMC13BackplaneDaqPort(uint32_t aSlot, DummyAMC13Driver &aDriver);
+            AMC13BackplaneDaqPort(uint32_t aSlot, DummyAMC13StatusCache &aStatusCache);
             ~AMC13BackplaneDaqPort();
 
+            //! True if the status changed, or couldn't be read, in the latest metric update
+            bool isDirty() const;
+
+            //! Controls how often the values are re-read from the hardware
+            DummyRefreshTimer &getRefreshTimer();
+
         private:
             void retrieveMetricValues();
 
-            DummyAMC13Driver &mDriver;
+            DummyAMC13StatusCache &mStatusCache;
             swatch::core::SimpleMetric<bool> &mOOS;
             swatch::core::SimpleMetric<bool> &mTTSWarning;
             swatch::core::SimpleMetric<uint64_t> &mAMCEventCount;
+            DummyChangeTracker<DummyAMC13Driver::AMCPortStatus> mChangeTracker;
+            DummyRefreshTimer mRefreshTimer;
         };
 
         class AMC13EventBuilder : public swatch::dtm::EVBInterface
         {
         public:
-            AMC13EventBuilder(DummyAMC13Driver &aDriver);
+            AMC13EventBuilder(DummyAMC13StatusCache &aStatusCache);
             ~AMC13EventBuilder();
 
+            //! True if the status changed, or couldn't be read, in the latest metric update
+            bool isDirty() const;
+
+            //! Controls how often the values are re-read from the hardware
+            DummyRefreshTimer &getRefreshTimer();
+
         private:
             void retrieveMetricValues();
 
-            DummyAMC13Driver &mDriver;
+            DummyAMC13StatusCache &mStatusCache;
             swatch::core::SimpleMetric<bool> &mOOS;
             swatch::core::SimpleMetric<bool> &mTTSWarning;
             swatch::core::SimpleMetric<uint64_t> &mL1ACount;
+            DummyChangeTracker<DummyAMC13Driver::EventBuilderStatus> mChangeTracker;
+            DummyRefreshTimer mRefreshTimer;
         };
 
         class AMC13SLinkExpress : public swatch::dtm::SLinkExpress
         {
         public:
-            AMC13SLinkExpress(uint32_t aSfpID, DummyAMC13Driver &aDriver);
+            AMC13SLinkExpress(uint32_t aSfpID, DummyAMC13StatusCache &aStatusCache);
             ~AMC13SLinkExpress();
 
+            //! True if the status changed, or couldn't be read, in the latest metric update
+            bool isDirty() const;
+
+            //! Controls how often the values are re-read from the hardware
+            DummyRefreshTimer &getRefreshTimer();
+
         private:
             void retrieveMetricValues();
 
-            DummyAMC13Driver &mDriver;
+            DummyAMC13StatusCache &mStatusCache;
             swatch::core::SimpleMetric<bool> &mCoreInitialised;
             swatch::core::SimpleMetric<bool> &mBackPressure;
             swatch::core::SimpleMetric<uint32_t> &mWordsSent;
             swatch::core::SimpleMetric<uint32_t> &mPacketsSent;
+            DummyChangeTracker<DummyAMC13Driver::SLinkStatus> mChangeTracker;
+            DummyRefreshTimer mRefreshTimer;
         };
 
         class AMC13TTC : public swatch::dtm::TTCInterface
         {
         public:
-            AMC13TTC(DummyAMC13Driver &aDriver);
+            AMC13TTC(DummyAMC13StatusCache &aStatusCache);
             ~AMC13TTC();
 
+            //! True if the status changed, or couldn't be read, in the latest metric update
+            bool isDirty() const;
+
+            //! Controls how often the values are re-read from the hardware
+            DummyRefreshTimer &getRefreshTimer();
+
         private:
             void retrieveMetricValues();
 
-            DummyAMC13Driver &mDriver;
+            DummyAMC13StatusCache &mStatusCache;
             swatch::core::SimpleMetric<double> &mClockFreq;
             swatch::core::SimpleMetric<uint32_t> &mBC0Counter;
             swatch::core::SimpleMetric<uint32_t> &mErrCountBC0;
             swatch::core::SimpleMetric<uint32_t> &mErrCountSingleBit;
             swatch::core::SimpleMetric<uint32_t> &mErrCountDoubleBit;
             swatch::core::SimpleMetric<bool> &mWarningSign;
+            DummyChangeTracker<DummyAMC13Driver::TTCStatus> mChangeTracker;
+            DummyRefreshTimer mRefreshTimer;
         };
 
     } // namespace dummy
@@ -3,22 +3,60 @@
 #define _RPCOS4PH2_DUMMY_DUMMYAMC13MANAGER_HPP__
 
 
+// C++ headers
+#include <memory>
+#include <vector>
+
 // boost headers
+#include "boost/chrono.hpp"
+#include "boost/optional.hpp"
 #include "boost/smart_ptr/scoped_ptr.hpp"
 
 // SWATCH headers
 #include "swatch/core/AbstractStub.hpp"
 #include "swatch/dtm/DaqTTCManager.hpp"
+#include "swatch/dtm/DaqTTCStub.hpp"
+
+#include "rpcos4ph2/dummy/DummyAMC13Driver.hpp"
+#include "rpcos4ph2/dummy/DummyCircuitBreaker.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
+
+
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
 
-class DummyAMC13Driver;
+class AMC13BackplaneDaqPort;
+class AMC13EventBuilder;
+class AMC13SLinkExpress;
+class AMC13TTC;
+class DummyAMC13StatusCache;
 
 class DummyAMC13Manager : public swatch::dtm::DaqTTCManager {
 public:
+  //! Driver, status cache and monitoring interfaces of an AMC13; independent of the manager object, so can be built on any thread
+  struct Components {
+    Components();
+    ~Components();
+
+    std::unique_ptr<DummyAMC13Driver> driver;
+    std::unique_ptr<DummyAMC13StatusCache> statusCache;
+    std::unique_ptr<AMC13TTC> ttc;
+    std::unique_ptr<AMC13SLinkExpress> sLink;
+    std::vector<std::unique_ptr<AMC13BackplaneDaqPort> > amcPorts;
+    std::unique_ptr<AMC13EventBuilder> evb;
+
+    //! Time taken to build the components
+    boost::chrono::microseconds buildTime;
+  };
+
   DummyAMC13Manager( const swatch::core::AbstractStub& aStub );
 
   virtual ~DummyAMC13Manager();
@@ -28,10 +66,34 @@ public:
     return *mDriver;
   }
 
+  DummyAMC13StatusCache& getStatusCache()
+  {
+    return *mStatusCache;
+  }
+
+  //! Makes all of the board's values due to be re-read in the next monitoring cycle; called by commands that change the board's state
+  void expireRefreshTimers();
+
+  //! Applies the board's settings from the gatekeeper of the engaged configuration key (e.g. refresh periods, write verification); called by the cell
+  void engage(const swatch::action::GateKeeper& aGateKeeper);
+
 private:
   virtual void retrieveMetricValues();
 
   boost::scoped_ptr<DummyAMC13Driver> mDriver;
+  boost::scoped_ptr<DummyAMC13StatusCache> mStatusCache;
+  boost::optional<uint16_t> mFedId;
+  DummyRefreshTimer mFedIdTimer;
+
+  //! One per part of the status, so that an unreachable part doesn't stop the rest of the AMC13 from being polled
+  DummyCircuitBreaker mCircuitBreakers[DummyAMC13Driver::kNumStatusBlockParts];
+  //! Whether any part's breaker is open; the largest number of consecutive failures, summed trips, and longest backoff over the parts
+  swatch::core::SimpleMetric<bool>& mMetricCircuitBreakerOpen;
+  swatch::core::SimpleMetric<uint32_t>& mMetricConsecutiveFailures;
+  swatch::core::SimpleMetric<uint32_t>& mMetricCircuitBreakerTrips;
+  swatch::core::SimpleMetric<float>& mMetricPollingBackoff;
+
+  DummyRefreshTimerSet mRefreshTimers;
 };
 
 
@@ -5,6 +5,7 @@
 
 #include "rpcos4ph2/dummy/AbstractConfigureCommand.hpp"
 #include "rpcos4ph2/dummy/AbstractForceStateCommand.hpp"
+#include "rpcos4ph2/dummy/DummyPortIdList.hpp"
 
 
 namespace rpcos4ph2 {
@@ -28,6 +29,8 @@ public:
 
 private:
   void runAction(bool aGoIntoError);
+
+  uint64_t getAppliedConfiguration();
 };
 
 
@@ -38,6 +41,8 @@ public:
 
 private:
   void runAction(bool aGoIntoError);
+
+  uint64_t getAppliedConfiguration();
 };
 
 
@@ -48,6 +53,8 @@ public:
 
 private:
   void runAction(bool aGoIntoError);
+
+  uint64_t getAppliedConfiguration();
 };
 
 
@@ -58,6 +65,13 @@ public:
 
 private:
   void runAction(bool aGoIntoError);
+
+  uint64_t hashInputs(uint64_t aHash);
+
+  uint64_t getAppliedConfiguration();
+
+  std::vector<bool> mIncludedPorts;
+  DummyPortIdList mPortIds;
 };
 
 
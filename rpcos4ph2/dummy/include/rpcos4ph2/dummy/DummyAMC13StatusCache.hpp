@@ -0,0 +1,94 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYAMC13STATUSCACHE_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYAMC13STATUSCACHE_HPP__
+
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "boost/function.hpp"
+#include "boost/optional.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "rpcos4ph2/dummy/DummyAMC13Driver.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+class DummyMonitoringSweep;
+
+//! Caches the status of a dummy AMC13, in the same way as DummyProcStatusCache does for a processor: each block is re-read at
+//! most once per monitoring cycle (or after the driver has committed a change), and can be prefetched by the monitoring sweep
+class DummyAMC13StatusCache {
+public:
+  DummyAMC13StatusCache(const DummyAMC13Driver& aDriver, uint32_t aNumAMCPorts);
+
+  ~DummyAMC13StatusCache();
+
+  boost::optional<DummyAMC13Driver::TTCStatus> getTTCStatus();
+
+  boost::optional<DummyAMC13Driver::EventBuilderStatus> getEvbStatus();
+
+  boost::optional<DummyAMC13Driver::SLinkStatus> getSLinkStatus();
+
+  //! Slots are numbered from 1
+  boost::optional<DummyAMC13Driver::AMCPortStatus> getAMCPortStatus(uint32_t aSlotId);
+
+  //! Reads the FED ID via the monitoring sweep; throws if the read fails or overruns the sweep's deadline
+  uint16_t readFedId();
+
+  //! Probes one part of the AMC13 via the monitoring sweep; returns false if the part doesn't respond before the sweep's deadline
+  bool probe(DummyAMC13Driver::StatusBlockPart aPart);
+
+  //! Runs this board's driver reads through the sweep from now on, so that they're bounded by its deadline (or inline if NULL)
+  void attach(DummyMonitoringSweep* aSweep, size_t aBoard);
+
+  //! Starts a monitoring cycle: re-reads each part that was requested in the previous cycle
+  void prefetch();
+
+  //! Starts a monitoring cycle, running a sweep over all boards unless one has already prefetched this board's status; blocks are then re-read on first request
+  void startCycle();
+
+  //! While set, getters return immediately without a value (e.g. because a prefetch is stuck waiting for the hardware)
+  void setUnavailable(bool aUnavailable);
+
+private:
+  //! Records that a block was requested, and refreshes it via the sweep if stale; returns false if it couldn't be read in time
+  bool refresh(DummyAMC13Driver::StatusBlockPart aPart);
+
+  //! Locks mMutex, and refreshes the block if stale; run by the sweep
+  void readPart(DummyAMC13Driver::StatusBlockPart aPart);
+
+  //! Runs a driver read through the sweep (if attached); throws if it overruns the deadline
+  template <typename T>
+  T call(const boost::function<T ()>& aFunction, const std::string& aDescription);
+
+  //! Re-reads a block from the driver if it hasn't been read in this cycle, or if the driver has committed a change since;
+  //! mMutex must be locked by caller
+  void refreshIfStale(DummyAMC13Driver::StatusBlockPart aPart);
+
+  const DummyAMC13Driver& mDriver;
+  boost::optional<DummyAMC13Driver::TTCStatus> mTTC;
+  boost::optional<DummyAMC13Driver::EventBuilderStatus> mEvb;
+  boost::optional<DummyAMC13Driver::SLinkStatus> mSLink;
+  std::vector<boost::optional<DummyAMC13Driver::AMCPortStatus> > mAMCPorts;
+  bool mValid[DummyAMC13Driver::kNumStatusBlockParts];
+  //! Driver's commit count when each block was read
+  uint64_t mReadCommits[DummyAMC13Driver::kNumStatusBlockParts];
+  bool mRequested[DummyAMC13Driver::kNumStatusBlockParts];
+  //! True once a prefetch has started the current cycle
+  bool mPrefetched;
+  DummyMonitoringSweep* mSweep;
+  size_t mBoard;
+  std::atomic<bool> mUnavailable;
+  boost::mutex mMutex;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYAMC13STATUSCACHE_HPP__ */
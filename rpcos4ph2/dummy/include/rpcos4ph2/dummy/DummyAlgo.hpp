@@ -5,28 +5,43 @@
 
 #include <string>
 
+#include "boost/optional.hpp"
+
 #include "swatch/processor/AlgoInterface.hpp"
 
+#include "rpcos4ph2/dummy/DummyMetricArray.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
+
 
 namespace rpcos4ph2 {
 namespace dummy {
 
-class DummyProcDriver;
+class DummyProcStatusCache;
 
 //! Dummy algo interface implementation (used for testing)
 class DummyAlgo : public swatch::processor::AlgoInterface {
 public:
-  DummyAlgo(DummyProcDriver& aDriver);
+  DummyAlgo(DummyProcStatusCache& aStatusCache);
 
   virtual ~DummyAlgo();
 
   virtual void retrieveMetricValues();
 
+  //! Controls how often the values are re-read from the hardware
+  DummyRefreshTimer& getRefreshTimer();
+
+  //! Number of generic rate counters, i.e. metrics 'rate_counter_0' to 'rate_counter_<N-1>'
+  static const size_t kNumRateCounters;
+
 private:
-  DummyProcDriver& mDriver;
+  DummyProcStatusCache& mStatusCache;
 
   swatch::core::SimpleMetric<float>& mRateCounterA;
   swatch::core::SimpleMetric<float>& mRateCounterB;
+  DummyMetricArray<float> mRateCounters;
+  boost::optional<DummyProcDriver::AlgoStatus> mLastStatus;
+  DummyRefreshTimer mRefreshTimer;
 };
 
 } // namespace dummy
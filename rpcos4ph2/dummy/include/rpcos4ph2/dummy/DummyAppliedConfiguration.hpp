@@ -0,0 +1,53 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYAPPLIEDCONFIGURATION_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYAPPLIEDCONFIGURATION_HPP__
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "rpcos4ph2/dummy/ComponentState.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyAppliedConfiguration
+ * @brief Hash of the configuration last applied to each part of a board, so that commands can skip unchanged steps
+ *
+ * Each entry also records the state that the part was left in, and its hash is only returned while the part is still
+ * in that state. The drivers clear a part's entry whenever they change its state by any means other than configuring
+ * it (e.g. a reset, or forcing its state), so that it's then configured again.
+ */
+class DummyAppliedConfiguration {
+public:
+  explicit DummyAppliedConfiguration(size_t aNumParts);
+
+  ~DummyAppliedConfiguration();
+
+  //! Returns the hash of the part's configuration, or 0 if there's none or if the part isn't in the recorded state
+  uint64_t get(size_t aPart, ComponentState aCurrentState) const;
+
+  void set(size_t aPart, uint64_t aHash, ComponentState aState);
+
+  void clear(size_t aPart);
+
+  void clearAll();
+
+private:
+  struct Entry {
+    uint64_t hash;
+    ComponentState state;
+  };
+
+  std::vector<Entry> mEntries;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYAPPLIEDCONFIGURATION_HPP__ */
+
@@ -0,0 +1,121 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYARENA_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYARENA_HPP__
+
+
+#include <stddef.h>
+#include <vector>
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyArena
+ * @brief Bump allocator for short-lived objects that are all released together (e.g. those built while a transition runs)
+ *
+ * Allocations are carved out of large blocks, and individual allocations are never freed; instead reset() releases
+ * everything at once, in constant time, by rewinding to the start of the first block. The blocks are kept for the
+ * next round, so that repeated transitions reuse the same memory rather than fragmenting the heap.
+ *
+ * An arena isn't thread-safe, so each thread that needs one should have its own (e.g. a thread_local).
+ */
+class DummyArena {
+public:
+  DummyArena(size_t aBlockSize = kDefaultBlockSize);
+
+  ~DummyArena();
+
+  //! Returns aSize bytes aligned to aAlignment (a power of two no larger than the block alignment)
+  void* allocate(size_t aSize, size_t aAlignment);
+
+  //! Releases all allocations; blocks are kept for reuse, except for any oversized ones
+  void reset();
+
+  //! Bytes allocated since the last reset, including alignment padding
+  size_t getBytesAllocated() const;
+
+  //! Bytes held in blocks
+  size_t getBytesReserved() const;
+
+  static const size_t kDefaultBlockSize;
+
+private:
+  DummyArena(const DummyArena&);
+  DummyArena& operator=(const DummyArena&);
+
+  const size_t mBlockSize;
+  std::vector<char*> mBlocks;
+  //! Allocations larger than a block, each in a block of its own; freed on reset
+  std::vector<char*> mLargeBlocks;
+  size_t mLargeBytes;
+  size_t mCurrentBlock;
+  size_t mOffset;
+  size_t mBytesAllocated;
+};
+
+
+//! STL allocator that takes its memory from a DummyArena; deallocation is a no-op
+template <typename T>
+class DummyArenaAllocator {
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef DummyArenaAllocator<U> other;
+  };
+
+  DummyArenaAllocator(DummyArena& aArena) :
+    mArena(&aArena)
+  {
+  }
+
+  template <typename U>
+  DummyArenaAllocator(const DummyArenaAllocator<U>& aOther) :
+    mArena(&aOther.getArena())
+  {
+  }
+
+  T* allocate(size_t aCount)
+  {
+    return static_cast<T*>(mArena->allocate(aCount * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t)
+  {
+  }
+
+  DummyArena& getArena() const
+  {
+    return *mArena;
+  }
+
+  template <typename U>
+  bool operator==(const DummyArenaAllocator<U>& aOther) const
+  {
+    return mArena == &aOther.getArena();
+  }
+
+  template <typename U>
+  bool operator!=(const DummyArenaAllocator<U>& aOther) const
+  {
+    return mArena != &aOther.getArena();
+  }
+
+private:
+  DummyArena* mArena;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYARENA_HPP__ */
+
@@ -0,0 +1,83 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYBOARDBUILDER_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYBOARDBUILDER_HPP__
+
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "rpcos4ph2/dummy/DummyAMC13Manager.hpp"
+#include "rpcos4ph2/dummy/DummyProcessor.hpp"
+
+
+namespace swatch {
+namespace core {
+class AbstractStub;
+}
+namespace system {
+class SystemStub;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyBoardBuilder
+ * @brief Builds the components of dummy processors & AMC13 managers concurrently, ahead of the boards themselves
+ *
+ * The SWATCH factory creates boards one by one, in the order listed in the system description. Building the
+ * bulk of each board (driver, interfaces, ports & their metrics) across a pool of threads beforehand means
+ * that the factory only has to assemble the boards, while the order of the system tree is unchanged.
+ */
+class DummyBoardBuilder {
+public:
+  /**
+   * @class Scope
+   * @brief Builds the boards' components ahead (if enabled) on construction, and deletes any left over on destruction
+   *
+   * Intended as a base class of the system, listed before swatch::system::System, so that the components are also
+   * deleted if the construction of a board (and so of the system) throws.
+   */
+  class Scope {
+  public:
+    //! Prebuilds the components of the system's dummy boards if aNrThreads is more than 1, and if aStub is a system stub
+    Scope(const swatch::core::AbstractStub& aStub, size_t aNrThreads);
+
+    ~Scope();
+
+  private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+  };
+
+  //! Builds the components of all dummy boards in the system using aNrThreads threads, keeping them until the boards are created
+  static void prebuild(const swatch::system::SystemStub& aStub, size_t aNrThreads);
+
+  //! Returns the components built ahead for the processor, or builds them on the calling thread if there are none
+  static std::unique_ptr<DummyProcessor::Components> takeProcessorComponents(const swatch::processor::ProcessorStub& aStub);
+
+  //! Returns the components built ahead for the AMC13, or builds them on the calling thread if there are none
+  static std::unique_ptr<DummyAMC13Manager::Components> takeAMC13Components(const swatch::dtm::DaqTTCStub& aStub);
+
+  //! Deletes any components built ahead that haven't been taken by a board
+  static void clear();
+
+private:
+  DummyBoardBuilder();
+
+  static boost::mutex sMutex;
+  static std::map<std::string, std::unique_ptr<DummyProcessor::Components> > sProcessorComponents;
+  static std::map<std::string, std::unique_ptr<DummyAMC13Manager::Components> > sAMC13Components;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYBOARDBUILDER_HPP__ */
@@ -0,0 +1,84 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYCANCELTOKEN_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYCANCELTOKEN_HPP__
+
+
+#include <atomic>
+#include <set>
+#include <string>
+
+#include "boost/function.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+
+namespace swatch {
+namespace action {
+class Command;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+//! Lets another thread cancel a long-running command, which checks the token between its steps; a command that's waiting for
+//! its next step is woken up via the token's callback.
+//! Tokens are registered by board, so that the commands that SWATCH has scheduled or is running can be cancelled via cancelActive
+class DummyCancelToken {
+public:
+  //! Clears the token when the command's execution ends, so that a cancellation only applies to the execution that was
+  //! scheduled or running when it was requested (including one that hadn't started yet)
+  class Scope {
+  public:
+    explicit Scope(DummyCancelToken& aToken);
+    ~Scope();
+
+  private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+
+    DummyCancelToken& mToken;
+  };
+
+  //! Token of aCommand, which belongs to the board with ID aBoardId
+  DummyCancelToken(const swatch::action::Command& aCommand, const std::string& aBoardId);
+
+  ~DummyCancelToken();
+
+  //! Requests cancellation, and calls the callback (if any)
+  void cancel();
+
+  //! Clears any earlier cancellation request (e.g. when the command is scheduled by another command)
+  void reset();
+
+  bool isCancelled() const;
+
+  //! Sets the function that cancel() calls, e.g. to run a command's next step straight away rather than once it's due;
+  //! an empty function clears it
+  void setCallback(const boost::function<void ()>& aCallback);
+
+  //! Cancels the commands that SWATCH has scheduled or is running on the board with ID aBoardId (or on any board, if empty);
+  //! returns the number of commands cancelled
+  static size_t cancelActive(const std::string& aBoardId);
+
+private:
+  DummyCancelToken(const DummyCancelToken&);
+  DummyCancelToken& operator=(const DummyCancelToken&);
+
+  const swatch::action::Command& mCommand;
+  const std::string mBoardId;
+  std::atomic<bool> mCancelled;
+  boost::function<void ()> mCallback;
+  boost::mutex mMutex;
+
+  static boost::mutex sRegistryMutex;
+  static std::set<DummyCancelToken*> sRegistry;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYCANCELTOKEN_HPP__ */
+
@@ -0,0 +1,114 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYCHANGETRACKER_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYCHANGETRACKER_HPP__
+
+
+#include <stdint.h>
+
+#include "boost/optional.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyChangeTracker
+ * @brief Compares each status read from the driver with the previous one, to flag whether a monitorable object changed
+ *
+ * beginUpdate should be called before reading the status, and update once it's been read. If the read fails (i.e.
+ * update isn't called) the object is left dirty, and the next status read is treated as a change.
+ */
+template <typename StatusType>
+class DummyChangeTracker {
+public:
+  DummyChangeTracker();
+
+  void beginUpdate();
+
+  //! Records the latest status; returns true if it differs from the previous one
+  bool update(const StatusType& aStatus);
+
+  //! True if the status changed (or couldn't be read) in the latest update
+  bool isDirty() const;
+
+  //! Number of updates in which the status changed
+  uint64_t getNumChanges() const;
+
+  //! True if the status from the last complete update is available
+  bool hasLastStatus() const;
+
+  const StatusType& getLastStatus() const;
+
+private:
+  boost::optional<StatusType> mLastStatus;
+  bool mUpdateComplete;
+  bool mDirty;
+  uint64_t mNumChanges;
+};
+
+
+template <typename StatusType>
+DummyChangeTracker<StatusType>::DummyChangeTracker() :
+  mUpdateComplete(true),
+  mDirty(true),
+  mNumChanges(0)
+{
+}
+
+
+template <typename StatusType>
+void DummyChangeTracker<StatusType>::beginUpdate()
+{
+  // Previous update failed, so metrics haven't had the last status' values since then
+  if (!mUpdateComplete)
+    mLastStatus.reset();
+  mUpdateComplete = false;
+  mDirty = true;
+}
+
+
+template <typename StatusType>
+bool DummyChangeTracker<StatusType>::update(const StatusType& aStatus)
+{
+  mDirty = !(mLastStatus && (*mLastStatus == aStatus));
+  if (mDirty) {
+    mLastStatus = aStatus;
+    mNumChanges++;
+  }
+  mUpdateComplete = true;
+  return mDirty;
+}
+
+
+template <typename StatusType>
+bool DummyChangeTracker<StatusType>::isDirty() const
+{
+  return mDirty;
+}
+
+
+template <typename StatusType>
+uint64_t DummyChangeTracker<StatusType>::getNumChanges() const
+{
+  return mNumChanges;
+}
+
+
+template <typename StatusType>
+bool DummyChangeTracker<StatusType>::hasLastStatus() const
+{
+  return bool(mLastStatus);
+}
+
+
+template <typename StatusType>
+const StatusType& DummyChangeTracker<StatusType>::getLastStatus() const
+{
+  return *mLastStatus;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYCHANGETRACKER_HPP__ */
@@ -0,0 +1,81 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYCIRCUITBREAKER_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYCIRCUITBREAKER_HPP__
+
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "boost/chrono.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyCircuitBreaker
+ * @brief Decides whether a board's status (or that of one part of it) should be polled, based on how many consecutive monitoring cycles failed
+ *
+ * Closed: the board is polled as usual. After a given number of consecutive cycles with failed status reads, the
+ * breaker opens, and the board isn't polled until a backoff period has passed; a probe of the board is then due
+ * (half-open). A successful probe closes the breaker; a failed one re-opens it, doubling the backoff period.
+ */
+class DummyCircuitBreaker {
+public:
+  enum State {
+    kClosed,
+    kOpen,
+    kHalfOpen
+  };
+
+  DummyCircuitBreaker(size_t aFailureThreshold = kDefaultFailureThreshold,
+                      const boost::chrono::milliseconds& aInitialBackoff = kDefaultInitialBackoff,
+                      const boost::chrono::milliseconds& aMaxBackoff = kDefaultMaxBackoff);
+
+  ~DummyCircuitBreaker();
+
+  //! Records the outcome of the latest cycle, from the driver's running totals of status reads and failed status reads
+  void recordStatusReads(uint64_t aNumReads, uint64_t aNumFailedReads);
+
+  //! Returns true (and moves to half-open) if the breaker is open and its backoff period has passed
+  bool isProbeDue();
+
+  //! Records the outcome of a probe, closing or re-opening the breaker
+  void recordProbe(bool aSuccess);
+
+  State getState() const;
+
+  size_t getNumConsecutiveFailures() const;
+
+  //! Number of times that the breaker has opened after a run of failed cycles
+  uint32_t getNumTrips() const;
+
+  //! Current backoff period between probes
+  const boost::chrono::milliseconds& getBackoff() const;
+
+  static const size_t kDefaultFailureThreshold;
+  static const boost::chrono::milliseconds kDefaultInitialBackoff;
+  static const boost::chrono::milliseconds kDefaultMaxBackoff;
+
+private:
+  void open();
+
+  const size_t mFailureThreshold;
+  const boost::chrono::milliseconds mInitialBackoff;
+  const boost::chrono::milliseconds mMaxBackoff;
+
+  State mState;
+  size_t mNumConsecutiveFailures;
+  uint32_t mNumTrips;
+  boost::chrono::milliseconds mBackoff;
+  boost::chrono::steady_clock::time_point mNextProbeTime;
+  uint64_t mLastNumReads;
+  uint64_t mLastNumFailedReads;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYCIRCUITBREAKER_HPP__ */
+
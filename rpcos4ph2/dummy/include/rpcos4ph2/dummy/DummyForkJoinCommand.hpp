@@ -0,0 +1,102 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYFORKJOINCOMMAND_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYFORKJOINCOMMAND_HPP__
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/chrono.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "swatch/action/Command.hpp"
+
+#include "rpcos4ph2/dummy/AbstractConfigureCommand.hpp"
+#include "rpcos4ph2/dummy/DummyCancelToken.hpp"
+
+
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyForkJoinCommand
+ * @brief Runs several configure commands of the same board in parallel on the step scheduler, then waits for all of them
+ *
+ * Each branch starts once the branches it depends on have completed successfully; if any of them fails, it's not run.
+ * Each branch runs with its own command's parameters, as resolved from the gatekeeper when the board engages it (see
+ * engage), and its execution details are reported on this command prefixed with the branch's ID, along with the status &
+ * running time of each branch; its total of register round-trips is that of its branches. The command returns the worst
+ * of the branches' states; cancelling it cancels the branches that are running, and stops those that haven't yet started.
+ */
+class DummyForkJoinCommand : public swatch::action::Command {
+public:
+  DummyForkJoinCommand(const std::string& aId, swatch::action::ActionableObject& aActionable);
+
+  ~DummyForkJoinCommand();
+
+  //! Adds a branch, which runs after those listed (by command ID), so dependencies must have been added first
+  DummyForkJoinCommand& addBranch(AbstractConfigureCommand& aCommand, const std::vector<std::string>& aDependencies = std::vector<std::string>());
+
+  //! Resolves each branch's parameters from the gatekeeper's entries for the branch's own command; until then, the branches
+  //! run with their default parameters
+  void engage(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts);
+
+  //! Token for cancelling the current (or scheduled) execution; passed on to the branches that are running or yet to start
+  DummyCancelToken& getCancelToken();
+
+private:
+  State code(const swatch::core::XParameterSet& aParams);
+
+  //! Marks the branches whose dependencies have all finished as started, and returns those to run; those with a failed
+  //! dependency (or all of them, if cancelled meanwhile) end straight away instead. mMutex must be locked by caller
+  std::vector<size_t> takeReadyBranches();
+
+  //! Starts the given branches on the step scheduler; mMutex mustn't be locked, since a branch can finish straight away
+  void startBranches(const std::vector<size_t>& aIndices);
+
+  //! Records a branch's outcome, then starts the branches that were waiting for it; called on the step scheduler
+  void finishBranch(size_t aIndex, const AbstractConfigureCommand::Outcome& aOutcome);
+
+  struct Branch {
+    AbstractConfigureCommand* command;
+    std::vector<size_t> dependencies;
+    //! Parameters as of the last engage; replaced as a whole, so that a running execution keeps its own
+    boost::shared_ptr<const swatch::core::XParameterSet> params;
+    // State of the current execution
+    boost::shared_ptr<const swatch::core::XParameterSet> executionParams;
+    bool started;
+    bool finished;
+    boost::chrono::steady_clock::time_point startTime;
+    State state;
+    std::string message;
+    std::vector<std::pair<std::string, std::string> > details;
+    uint32_t roundTrips;
+  };
+
+  std::vector<Branch> mBranches;
+  DummyCancelToken mCancelToken;
+  boost::mutex mMutex;
+  boost::condition_variable mBranchFinished;
+  //! Index of this command in the transition profiler
+  const uint32_t mProfilerIndex;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYFORKJOINCOMMAND_HPP__ */
+
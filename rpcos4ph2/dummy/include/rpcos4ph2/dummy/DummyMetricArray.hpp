@@ -0,0 +1,115 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYMETRICARRAY_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYMETRICARRAY_HPP__
+
+
+#include <string>
+#include <vector>
+
+#include "swatch/core/MonitorableObject.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyMetricArray
+ * @brief Bank of homogeneous metrics with IDs "<prefix>0" to "<prefix>N-1", whose values are held in one contiguous buffer
+ *
+ * Registration and updates go through the owning monitorable object (since registerMetric and setMetricValue are
+ * protected), by passing it a functor - e.g. a lambda that captures 'this' - once for the whole bank. The value
+ * buffer can be filled by the driver in a single block copy, before being pushed to the metrics.
+ */
+template <typename DataType>
+class DummyMetricArray {
+public:
+  typedef swatch::core::SimpleMetric<DataType> Metric_t;
+
+  DummyMetricArray(const std::string& aIdPrefix, size_t aSize);
+
+  size_t size() const;
+
+  const std::string& getId(size_t aIndex) const;
+
+  //! Registers all metrics in the bank; aRegister is called with each metric ID, and must return the registered metric
+  template <class RegisterFunction>
+  void registerMetrics(RegisterFunction aRegister);
+
+  //! Contiguous buffer of values, one per metric
+  std::vector<DataType>& getValues();
+
+  const std::vector<DataType>& getValues() const;
+
+  //! Pushes each value from the buffer to its metric; aSetValue is called with each metric and its new value
+  template <class SetValueFunction>
+  void pushValues(SetValueFunction aSetValue) const;
+
+private:
+  std::vector<std::string> mIds;
+  std::vector<Metric_t*> mMetrics;
+  std::vector<DataType> mValues;
+};
+
+
+template <typename DataType>
+DummyMetricArray<DataType>::DummyMetricArray(const std::string& aIdPrefix, size_t aSize) :
+  mValues(aSize, DataType())
+{
+  mIds.reserve(aSize);
+  for (size_t i = 0; i < aSize; i++)
+    mIds.push_back(aIdPrefix + std::to_string(i));
+}
+
+
+template <typename DataType>
+size_t DummyMetricArray<DataType>::size() const
+{
+  return mIds.size();
+}
+
+
+template <typename DataType>
+const std::string& DummyMetricArray<DataType>::getId(size_t aIndex) const
+{
+  return mIds.at(aIndex);
+}
+
+
+template <typename DataType>
+template <class RegisterFunction>
+void DummyMetricArray<DataType>::registerMetrics(RegisterFunction aRegister)
+{
+  mMetrics.clear();
+  mMetrics.reserve(mIds.size());
+  for (auto lIt = mIds.begin(); lIt != mIds.end(); lIt++)
+    mMetrics.push_back(&aRegister(*lIt));
+}
+
+
+template <typename DataType>
+std::vector<DataType>& DummyMetricArray<DataType>::getValues()
+{
+  return mValues;
+}
+
+
+template <typename DataType>
+const std::vector<DataType>& DummyMetricArray<DataType>::getValues() const
+{
+  return mValues;
+}
+
+
+template <typename DataType>
+template <class SetValueFunction>
+void DummyMetricArray<DataType>::pushValues(SetValueFunction aSetValue) const
+{
+  for (size_t i = 0; i < mMetrics.size(); i++)
+    aSetValue(*mMetrics[i], mValues[i]);
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYMETRICARRAY_HPP__ */
@@ -0,0 +1,65 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYMONITORINGSCHEDULE_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYMONITORINGSCHEDULE_HPP__
+
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/chrono.hpp"
+
+
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyMonitoringSchedule
+ * @brief Refresh periods of a dummy board's monitorable objects & metrics, from the gatekeeper's 'refreshPeriods' parameter
+ *
+ * The parameter is a table with columns 'state', 'path' and 'period' (in seconds), e.g. the row
+ * 'Running,firmwareVersion,300'; a period applies in the given FSM state (or in all states, if empty) to the whole
+ * subtree below that path. The table is looked up in each of the board's gatekeeper contexts in turn, and entries from
+ * earlier contexts (e.g. the board's own) take precedence over those from later ones (e.g. 'processors').
+ */
+class DummyMonitoringSchedule {
+public:
+  //! Empty schedule, i.e. values are re-read in every cycle
+  DummyMonitoringSchedule();
+
+  //! Reads the periods from the gatekeeper, in the board's contexts (in order of precedence)
+  DummyMonitoringSchedule(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts);
+
+  ~DummyMonitoringSchedule();
+
+  //! ID of the gatekeeper parameter that holds the periods
+  static const std::string kParameterId;
+
+  //! Returns the refresh period for the object/metric at aPath in FSM state aState, or 0 (i.e. every cycle) if not set
+  boost::chrono::milliseconds getPeriod(const std::string& aState, const std::string& aPath) const;
+
+  size_t size() const;
+
+private:
+  // Periods indexed by FSM state, then by object path
+  typedef std::map<std::string, std::map<std::string, boost::chrono::milliseconds> > PeriodMap_t;
+
+  //! Longest matching period within a context's periods & state; returns false if there's no match
+  static bool findPeriod(const PeriodMap_t& aPeriods, const std::string& aState, const std::string& aPath, boost::chrono::milliseconds& aPeriod);
+
+  // Periods of each context that has any, in order of precedence
+  std::vector<PeriodMap_t> mPeriods;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYMONITORINGSCHEDULE_HPP__ */
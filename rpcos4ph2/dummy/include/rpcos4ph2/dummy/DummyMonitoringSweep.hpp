@@ -0,0 +1,154 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYMONITORINGSWEEP_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYMONITORINGSWEEP_HPP__
+
+
+#include <deque>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/bind.hpp"
+#include "boost/chrono.hpp"
+#include "boost/function.hpp"
+#include "boost/optional.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/thread.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyMonitoringSweep
+ * @brief Runs the boards' hardware reads across a bounded pool of threads, waiting at most until a per-board deadline
+ *
+ * Each board's status cache runs its reads through the sweep, so the deadline applies wherever SWATCH calls into a
+ * board. A read that overruns it leaves the board flagged as overdue via its callback. The board then isn't given a
+ * new task until the previous one has finished, so one hung board can neither stall the monitoring cycle nor tie up
+ * more than one thread.
+ *
+ * The first board to start a new monitoring cycle also runs a sweep, which prefetches every board's status
+ * concurrently; the other boards' metric updates are then served from their caches, whatever order SWATCH updates
+ * the boards in.
+ *
+ * On destruction, workers that are still busy after a further deadline are detached rather than joined (their
+ * task's overdue callback is then no longer called), so that a hung board can't block the system's destruction.
+ */
+class DummyMonitoringSweep {
+public:
+  //! Summary of a sweep; latencies are only listed for the boards that finished within the deadline
+  struct Result {
+    Result();
+
+    boost::chrono::microseconds wallTime;
+    std::vector<boost::chrono::microseconds> latencies;
+    size_t numOverdue;
+  };
+
+  DummyMonitoringSweep(size_t aMaxThreads, boost::chrono::milliseconds aDeadline);
+  ~DummyMonitoringSweep();
+
+  //! Sets the maximum number of tasks run at once, and the per-board deadline; can be called at any time (e.g. once a configuration key is engaged)
+  void configure(size_t aMaxThreads, boost::chrono::milliseconds aDeadline);
+
+  //! Adds a board and returns its index. aPrefetch is run in each sweep, and aSetOverdue is called with true when one of the
+  //! board's tasks overruns the deadline, and with false once that task finishes
+  size_t addBoard(const std::string& aId, const boost::function<void ()>& aPrefetch, const boost::function<void (bool)>& aSetOverdue);
+
+  //! Runs every board's prefetch (unless its previous task is still running), and waits until all finish or the deadline passes
+  void run();
+
+  //! Runs a task for one board (e.g. reading part of its status), and waits until it finishes or the deadline passes;
+  //! returns false if it didn't finish in time, or if the board's previous task is still running
+  bool run(size_t aBoard, const boost::function<void ()>& aFunction);
+
+  //! Runs a function for one board in the same way, and returns its result (rethrowing any exception that it threw);
+  //! returns an empty optional if it didn't finish in time, or if the board's previous task is still running
+  template <typename T>
+  boost::optional<T> call(size_t aBoard, const boost::function<T ()>& aFunction);
+
+  //! Summary of the latest sweep
+  Result getLastResult() const;
+
+private:
+  struct Task {
+    std::string id;
+    boost::function<void ()> prefetch;
+    boost::function<void (bool)> setOverdue;
+    //! Function that's queued or running
+    boost::function<void ()> function;
+    bool running;
+    bool finished;
+    boost::chrono::steady_clock::time_point startTime;
+    boost::chrono::microseconds latency;
+  };
+
+  //! State shared with the workers, which keep it alive in case they're detached on destruction
+  struct State {
+    State();
+    std::vector<Task> tasks;
+    std::deque<size_t> queue;
+    size_t maxThreads;
+    size_t numBusy;
+    size_t numIdle;
+    bool stopping;
+    mutable boost::mutex mutex;
+    boost::condition_variable taskQueued;
+    boost::condition_variable taskFinished;
+  };
+
+  //! Queues the board's task, starting another worker if none is idle; mState->mutex must be locked by caller
+  void dispatch(size_t aBoard, const boost::function<void ()>& aFunction, const boost::chrono::steady_clock::time_point& aStartTime);
+
+  static void runWorker(const boost::shared_ptr<State>& aState);
+
+  //! Result of a call, which outlives the caller if the call overruns the deadline
+  template <typename T>
+  struct CallResult {
+    boost::optional<T> value;
+    std::exception_ptr exception;
+  };
+
+  template <typename T>
+  static void runCall(const boost::function<T ()>& aFunction, const boost::shared_ptr<CallResult<T> >& aResult);
+
+  boost::chrono::milliseconds mDeadline;
+  Result mLastResult;
+  boost::shared_ptr<State> mState;
+  std::vector<std::unique_ptr<boost::thread> > mWorkers;
+};
+
+
+template <typename T>
+boost::optional<T> DummyMonitoringSweep::call(size_t aBoard, const boost::function<T ()>& aFunction)
+{
+  const boost::shared_ptr<CallResult<T> > lResult(new CallResult<T>());
+  if (!run(aBoard, boost::bind(&DummyMonitoringSweep::runCall<T>, aFunction, lResult)))
+    return boost::none;
+  if (lResult->exception)
+    std::rethrow_exception(lResult->exception);
+  return lResult->value;
+}
+
+
+template <typename T>
+void DummyMonitoringSweep::runCall(const boost::function<T ()>& aFunction, const boost::shared_ptr<CallResult<T> >& aResult)
+{
+  try {
+    aResult->value = aFunction();
+  }
+  catch (...) {
+    aResult->exception = std::current_exception();
+  }
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYMONITORINGSWEEP_HPP__ */
@@ -0,0 +1,91 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYPORTAGGREGATOR_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYPORTAGGREGATOR_HPP__
+
+
+#include <stdint.h>
+#include <vector>
+
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+
+namespace swatch {
+namespace core {
+class MetricSnapshot;
+class MonitorableObjectSnapshot;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyPortAggregator
+ * @brief Running totals of CRC errors and ports in error across a processor's input ports
+ *
+ * Each port pushes its latest values into its own slot when it updates its metrics; only the difference from the
+ * slot's previous contents is applied to the totals. Masked ports and ports whose monitoring is disabled don't
+ * contribute, and any other port whose values are unknown makes the totals unknown.
+ *
+ * The totals are published through the processor's complex metrics, whose calculate functions read them rather than
+ * summing the ports' snapshots; since SWATCH evaluates these metrics from the ports' latest metric values, the ports
+ * have already pushed those same values into their slots.
+ */
+class DummyPortAggregator {
+public:
+  DummyPortAggregator(size_t aNumSlots);
+
+  ~DummyPortAggregator();
+
+  size_t getNumSlots() const;
+
+  //! Records the latest values of the port in the specified slot
+  void update(size_t aSlot, uint32_t aCRCErrors, bool aIsInError);
+
+  //! Records that the latest values of the port in the specified slot are unknown
+  void setUnknown(size_t aSlot);
+
+  //! Records whether the port in the specified slot is masked; compared with the slot's own flag, so can be called by anyone, in any order
+  void setMasked(size_t aSlot, bool aIsMasked);
+
+  //! Records whether the monitoring of the port in the specified slot is disabled (i.e. its values aren't refreshed)
+  void setDisabled(size_t aSlot, bool aIsDisabled);
+
+  //! Returns the running totals; false if the value of any unmasked, enabled port is unknown
+  bool getTotals(uint32_t& aCRCErrors, uint32_t& aNumInError) const;
+
+  //! ComplexMetric calculate function for the total CRC errors (SWATCH takes ownership of the returned value; NULL if unknown)
+  const uint32_t* calculateTotalCRCErrors(const std::vector<swatch::core::MetricSnapshot>& aSnapshots) const;
+
+  //! ComplexMetric calculate function for the number of ports in error (SWATCH takes ownership of the returned value; NULL if unknown)
+  const uint32_t* calculateNumberInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& aSnapshots) const;
+
+private:
+  struct Slot {
+    Slot();
+
+    bool isKnown;
+    bool isMasked;
+    bool isDisabled;
+    uint32_t crcErrors;
+    bool isInError;
+  };
+
+  //! Adds/removes the slot's contribution to/from the totals; mMutex must be locked by caller
+  void add(const Slot& aSlot);
+  void remove(const Slot& aSlot);
+
+  std::vector<Slot> mSlots;
+  uint32_t mTotalCRCErrors;
+  uint32_t mNumInError;
+  size_t mNumUnknown;
+  mutable boost::mutex mMutex;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYPORTAGGREGATOR_HPP__ */
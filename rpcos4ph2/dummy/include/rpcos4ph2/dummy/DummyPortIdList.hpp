@@ -0,0 +1,71 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYPORTIDLIST_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYPORTIDLIST_HPP__
+
+
+#include <stddef.h>
+#include <vector>
+
+#include "xdata/String.h"
+#include "xdata/Vector.h"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyPortIdList
+ * @brief IDs of the ports that a command acts on, for its execution details; only rebuilt when the set of ports changes
+ *
+ * A command keeps one of these, and on each run passes in which ports are included (e.g. the unmasked ones), as a
+ * bitmap indexed by position in the port collection. The list of IDs is built once, and then reused for as long as
+ * the bitmap stays the same, rather than building a new string per port on every run.
+ */
+class DummyPortIdList {
+public:
+  DummyPortIdList();
+
+  ~DummyPortIdList();
+
+  //! Returns the IDs of the ports in aPorts (a collection of port pointers) whose bit is set in aIncluded
+  template <class PortCollection>
+  const xdata::Vector<xdata::String>& get(const PortCollection& aPorts, const std::vector<bool>& aIncluded);
+
+  //! Number of times that the list has been (re)built
+  size_t getNumBuilds() const;
+
+private:
+  DummyPortIdList(const DummyPortIdList&); // non-copyable
+  DummyPortIdList& operator=(const DummyPortIdList&); // non-assignable
+
+  bool mValid;
+  std::vector<bool> mIncluded;
+  xdata::Vector<xdata::String> mIds;
+  size_t mNumBuilds;
+};
+
+
+template <class PortCollection>
+const xdata::Vector<xdata::String>& DummyPortIdList::get(const PortCollection& aPorts, const std::vector<bool>& aIncluded)
+{
+  if (mValid && (aIncluded == mIncluded))
+    return mIds;
+
+  mIds.clear();
+  size_t i = 0;
+  for (auto lIt = aPorts.begin(); lIt != aPorts.end(); lIt++, i++) {
+    if ((i < aIncluded.size()) && aIncluded.at(i))
+      mIds.push_back((*lIt)->getId());
+  }
+  mIncluded = aIncluded;
+  mValid = true;
+  mNumBuilds++;
+  return mIds;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYPORTIDLIST_HPP__ */
+
@@ -0,0 +1,53 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYPORTMASK_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYPORTMASK_HPP__
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyPortMask
+ * @brief Packed bitset of which of a processor's input ports are masked, indexed by position in the port collection
+ *
+ * Bits are only written when a port's mask changes, and can be read from any thread without locking, so checking
+ * a port's mask is a single bit test rather than a dynamic_cast plus virtual call.
+ */
+class DummyPortMask {
+public:
+  DummyPortMask(size_t aNumPorts);
+
+  ~DummyPortMask();
+
+  size_t size() const;
+
+  bool isMasked(size_t aIndex) const;
+
+  //! Updates the bit for the specified port; only writes to the bitset (and returns true) if the value has changed
+  bool setMasked(size_t aIndex, bool aIsMasked);
+
+  //! Number of masked ports
+  size_t count() const;
+
+private:
+  DummyPortMask(const DummyPortMask&); // non-copyable
+  DummyPortMask& operator=(const DummyPortMask&); // non-assignable
+
+  static const size_t kBitsPerWord = 64;
+
+  size_t mNumPorts;
+  std::vector<std::atomic<uint64_t> > mWords;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYPORTMASK_HPP__ */
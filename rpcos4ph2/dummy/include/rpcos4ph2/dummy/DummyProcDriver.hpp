@@ -4,10 +4,18 @@
 
 
 #include <stdint.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
+#include "boost/optional.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
 #include "rpcos4ph2/dummy/ComponentState.hpp"
+#include "rpcos4ph2/dummy/DummyAppliedConfiguration.hpp"
+#include "rpcos4ph2/dummy/DummyRegisterMap.hpp"
+#include "rpcos4ph2/dummy/DummyRegisterTransaction.hpp"
 #include "swatch/core/TTSUtils.hpp"
 
 
@@ -23,6 +31,26 @@ public:
   struct RxPortStatus;
   struct TxPortStatus;
   struct AlgoStatus;
+  struct StatusBlock;
+
+  //! Independently-readable parts of the status block
+  enum StatusBlockPart {
+    kTTCPart,
+    kReadoutPart,
+    kAlgoPart,
+    kRxPart,
+    kTxPart,
+    kNumStatusBlockParts
+  };
+
+  //! Parts of the board that are each configured by a separate command, whose last-applied configuration is tracked
+  enum ConfigurationPart {
+    kRxConfig,
+    kTxConfig,
+    kReadoutConfig,
+    kAlgoConfig,
+    kNumConfigurationParts
+  };
 
   DummyProcDriver();
 
@@ -40,6 +68,51 @@ public:
 
   AlgoStatus getAlgoStatus() const;
 
+  // Variants of the above that return an empty optional if the block isn't reachable, rather than throwing; they still
+  // throw if the channel ID is beyond the register map's kMaxChannels
+  boost::optional<TTCStatus> tryGetTTCStatus() const;
+
+  boost::optional<ReadoutStatus> tryGetReadoutStatus() const;
+
+  boost::optional<RxPortStatus> tryGetRxPortStatus(uint32_t aChannelId) const;
+
+  boost::optional<TxPortStatus> tryGetTxPortStatus(uint32_t aChannelId) const;
+
+  boost::optional<AlgoStatus> tryGetAlgoStatus() const;
+
+  //! Reads the status of all blocks & channels in a single transaction, filling the pre-allocated block
+  void readAllStatus(StatusBlock& aBlock) const;
+
+  //! Reads one part of the status block (e.g. all rx channels), leaving the rest of the block unchanged
+  void readStatus(StatusBlock& aBlock, StatusBlockPart aPart) const;
+
+  //! Checks whether the board responds again (reads the firmware version, and the state of each block)
+  bool probe() const;
+
+  //! Checks whether one part of the board responds again (reads the firmware version, and the state of that part's block)
+  bool probe(StatusBlockPart aPart) const;
+
+  //! While suspended, status reads of the part report it as not reachable without accessing the registers
+  void setStatusPollingSuspended(StatusBlockPart aPart, bool aSuspended);
+
+  //! Number of status reads of a part's block (or channels) since construction, and how many of those found it not reachable
+  uint64_t getNumStatusReads(StatusBlockPart aPart) const;
+  uint64_t getNumFailedStatusReads(StatusBlockPart aPart) const;
+
+  //! Number of configuration transactions committed since construction, i.e. changes to the state of the board
+  uint64_t getNumCommits() const;
+
+  //! Hash of the configuration last applied to a part of the board; 0 if there's none, or if the part's state has since changed
+  uint64_t getAppliedConfiguration(ConfigurationPart aPart) const;
+
+  //! Records the hash of the configuration that's just been applied to a part of the board, along with its current state
+  void setAppliedConfiguration(ConfigurationPart aPart, uint64_t aHash);
+
+  //! If enabled, configuration writes are read back (in a second round-trip) to check them
+  void setWriteVerification(bool aVerify);
+
+  // Each of the following stages its register writes, and sends them to the board in a single round-trip; they're
+  // serialised by the driver, so that commands configuring independent blocks can run concurrently
   void reboot();
 
   void reset();
@@ -62,15 +135,49 @@ public:
 
   void forceAlgoState(ComponentState aNewState);
 
+  //! Simulated register space of the board, e.g. for benchmarking access patterns
+  DummyRegisterMap& getRegisterMap();
+
+  //! Maximum number of rx/tx channels in the register map
+  static const size_t kMaxChannels;
+
+  //! Maximum number of generic algo rate counters in the register map
+  static const size_t kMaxAlgoRateCounters;
+
 private:
+  // Emulate the firmware: update the state register of each block, along with the status registers derived from it;
+  // the writes are staged in the transaction, until it's committed
+  void setClkTtcState(ComponentState aNewState);
+  void setRxState(ComponentState aNewState);
+  void setTxState(ComponentState aNewState);
+  void setReadoutState(ComponentState aNewState);
+  void setAlgoState(ComponentState aNewState);
+
+  void commit();
+
+  ComponentState readState(uint32_t aAddress) const;
+
+  //! Current state of a configurable part
+  ComponentState readState(ConfigurationPart aPart) const;
 
-  std::vector<uint8_t> mVec;
+  //! Counts a status read of a part in the given state; returns false if it's not reachable
+  bool recordStatusRead(StatusBlockPart aPart, ComponentState aState) const;
 
-  ComponentState mClkState;
-  ComponentState mTxState;
-  ComponentState mRxState;
-  ComponentState mReadoutState;
-  ComponentState mAlgoState;
+  static TTCStatus decodeTTCStatus(const uint32_t* aBlock);
+  static ReadoutStatus decodeReadoutStatus(const uint32_t* aBlock);
+  static AlgoStatus decodeAlgoStatus(const uint32_t* aBlock);
+
+  DummyRegisterMap mRegisters;
+  DummyRegisterTransaction mTransaction;
+  bool mVerifyWrites;
+  DummyAppliedConfiguration mAppliedConfiguration;
+  //! Guards the transaction & applied configuration, for commands that configure blocks in parallel
+  mutable boost::mutex mConfigurationMutex;
+
+  std::atomic<bool> mStatusPollingSuspended[kNumStatusBlockParts];
+  mutable std::atomic<uint64_t> mNumStatusReads[kNumStatusBlockParts];
+  mutable std::atomic<uint64_t> mNumFailedStatusReads[kNumStatusBlockParts];
+  std::atomic<uint64_t> mNumCommits;
 
 public:
   struct TTCStatus {
@@ -83,6 +190,8 @@ public:
     uint32_t errSingleBit;
     uint32_t errDoubleBit;
     bool warningSign;
+
+    bool operator==(const TTCStatus& aOther) const;
   };
 
   struct ReadoutStatus {
@@ -94,6 +203,8 @@ public:
     bool amcCoreReady;
     swatch::core::tts::State ttsState;
     uint32_t eventCounter;
+
+    bool operator==(const ReadoutStatus& aOther) const;
   };
 
   struct RxPortStatus {
@@ -107,6 +218,8 @@ public:
     bool isAligned;
     uint32_t crcErrCount;
     bool warningSign;
+
+    bool operator==(const RxPortStatus& aOther) const;
   };
 
   struct TxPortStatus {
@@ -116,6 +229,8 @@ public:
     {}
     bool isOperating;
     bool warningSign;
+
+    bool operator==(const TxPortStatus& aOther) const;
   };
 
   struct AlgoStatus {
@@ -126,6 +241,34 @@ public:
     float rateCounterA;
     float rateCounterB;
   };
+
+  //! Status of the whole board; per-channel values stored as arrays indexed by channel ID
+  struct StatusBlock {
+    StatusBlock(size_t aNumRxChannels, size_t aNumTxChannels, size_t aNumAlgoRateCounters);
+
+    bool ttcReachable;
+    TTCStatus ttc;
+
+    bool readoutReachable;
+    ReadoutStatus readout;
+
+    bool algoReachable;
+    AlgoStatus algo;
+    std::vector<float> algoRateCounters;
+
+    bool rxReachable;
+    std::vector<uint8_t> rxIsLocked;
+    std::vector<uint8_t> rxIsAligned;
+    std::vector<uint32_t> rxCrcErrCount;
+    std::vector<uint8_t> rxWarningSign;
+
+    bool txReachable;
+    std::vector<uint8_t> txIsOperating;
+    std::vector<uint8_t> txWarningSign;
+
+    //! Scratch space for the rx/tx channel status words, as read from the registers before decoding
+    std::vector<uint32_t> channelWords;
+  };
 };
 
 
@@ -0,0 +1,97 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYPROCSTATUSCACHE_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYPROCSTATUSCACHE_HPP__
+
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "boost/function.hpp"
+#include "boost/optional.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+class DummyMonitoringSweep;
+
+//! Caches the status of a whole dummy processor, so that the board's monitorable objects share one driver read of each part per monitoring cycle;
+//! a part is re-read at the start of each cycle, and whenever the driver has committed a change to the board since it was read
+//! Getters return an empty optional (rather than throwing) if that part of the board isn't reachable, so that an unreachable
+//! part is detected once per read, and all of its objects can then be marked as unknown without unwinding the stack per object
+class DummyProcStatusCache {
+public:
+  DummyProcStatusCache(const DummyProcDriver& aDriver, size_t aNumRxChannels, size_t aNumTxChannels, size_t aNumAlgoRateCounters);
+
+  ~DummyProcStatusCache();
+
+  boost::optional<DummyProcDriver::TTCStatus> getTTCStatus();
+
+  boost::optional<DummyProcDriver::ReadoutStatus> getReadoutStatus();
+
+  boost::optional<DummyProcDriver::AlgoStatus> getAlgoStatus();
+
+  //! Copies the algo rate counters into aValues, which must be no larger than the cached array; returns false if not reachable
+  bool getAlgoRateCounters(std::vector<float>& aValues);
+
+  boost::optional<DummyProcDriver::RxPortStatus> getRxPortStatus(uint32_t aChannelId);
+
+  boost::optional<DummyProcDriver::TxPortStatus> getTxPortStatus(uint32_t aChannelId);
+
+  //! Reads the firmware version via the monitoring sweep; throws if the read fails or overruns the sweep's deadline
+  uint64_t readFirmwareVersion();
+
+  //! Probes one part of the board via the monitoring sweep; returns false if the part doesn't respond before the sweep's deadline
+  bool probe(DummyProcDriver::StatusBlockPart aPart);
+
+  //! Runs this board's driver reads through the sweep from now on, so that they're bounded by its deadline (or inline if NULL)
+  void attach(DummyMonitoringSweep* aSweep, size_t aBoard);
+
+  //! Starts a monitoring cycle: re-reads each part of the status block that was requested in the previous cycle
+  void prefetch();
+
+  //! Starts a monitoring cycle, running a sweep over all boards unless one has already prefetched this board's status; parts are then re-read on first request
+  void startCycle();
+
+  //! While set, getters return immediately without a value (e.g. because a prefetch is stuck waiting for the hardware)
+  void setUnavailable(bool aUnavailable);
+
+private:
+  //! Records that a part was requested, and refreshes it via the sweep if stale; returns false if it couldn't be read in time
+  bool refresh(DummyProcDriver::StatusBlockPart aPart);
+
+  //! Locks mMutex, and refreshes the part if stale; run by the sweep
+  void readPart(DummyProcDriver::StatusBlockPart aPart);
+
+  //! Runs a driver read through the sweep (if attached); throws if it overruns the deadline
+  template <typename T>
+  T call(const boost::function<T ()>& aFunction, const std::string& aDescription);
+
+  //! Re-reads one part of the status block from the driver if it hasn't been read in this cycle, or if the driver has
+  //! committed a change since; mMutex must be locked by caller
+  void refreshIfStale(DummyProcDriver::StatusBlockPart aPart);
+
+  const DummyProcDriver& mDriver;
+  DummyProcDriver::StatusBlock mBlock;
+  bool mValid[DummyProcDriver::kNumStatusBlockParts];
+  //! Driver's commit count when each part was read
+  uint64_t mReadCommits[DummyProcDriver::kNumStatusBlockParts];
+  bool mRequested[DummyProcDriver::kNumStatusBlockParts];
+  //! True once a prefetch has started the current cycle
+  bool mPrefetched;
+  DummyMonitoringSweep* mSweep;
+  size_t mBoard;
+  std::atomic<bool> mUnavailable;
+  boost::mutex mMutex;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYPROCSTATUSCACHE_HPP__ */
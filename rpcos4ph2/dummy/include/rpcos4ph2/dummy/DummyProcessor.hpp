@@ -3,26 +3,63 @@
 #define _RPCOS4PH2_DUMMY_DUMMYPROCESSOR_HPP__
 
 
+// C++ headers
+#include <memory>
+#include <vector>
+
 // boost headers
+#include "boost/chrono.hpp"
+#include "boost/optional.hpp"
 #include "boost/scoped_ptr.hpp"
 
 // SWATCH headers
 #include "swatch/processor/Processor.hpp"
 
+#include "rpcos4ph2/dummy/DummyCircuitBreaker.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
 
-namespace rpcos4ph2 {
-namespace dummy {
-
-class DummyProcDriver;
 
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
 
-bool filterOutMaskedPorts(const swatch::core::MonitorableObject& aObj);
 
-const uint32_t* sumUpCRCErrors(const std::vector<swatch::core::MetricSnapshot>& aSnapshots);
+namespace rpcos4ph2 {
+namespace dummy {
 
+class DummyAlgo;
+class DummyPortAggregator;
+class DummyPortMask;
+class DummyProcStatusCache;
+class DummyReadoutInterface;
+class DummyRxPort;
+class DummyTTC;
+class DummyTxPort;
 
 class DummyProcessor : public swatch::processor::Processor {
 public:
+  //! Driver, status cache, interfaces and ports of a processor; independent of the processor object, so can be built on any thread
+  struct Components {
+    Components(const swatch::processor::ProcessorStub& aStub);
+    ~Components();
+
+    std::unique_ptr<DummyProcDriver> driver;
+    std::unique_ptr<DummyProcStatusCache> statusCache;
+    std::unique_ptr<DummyPortAggregator> portAggregator;
+    std::unique_ptr<DummyPortMask> portMask;
+    std::unique_ptr<DummyTTC> ttc;
+    std::unique_ptr<DummyReadoutInterface> readout;
+    std::unique_ptr<DummyAlgo> algo;
+    std::vector<std::unique_ptr<DummyRxPort> > rxPorts;
+    std::vector<std::unique_ptr<DummyTxPort> > txPorts;
+
+    //! Time taken to build the components
+    boost::chrono::microseconds buildTime;
+  };
+
   DummyProcessor( const swatch::core::AbstractStub& aStub );
   virtual ~DummyProcessor();
 
@@ -33,11 +70,47 @@ public:
     return *mDriver;
   }
 
+  DummyProcStatusCache& getStatusCache()
+  {
+    return *mStatusCache;
+  }
+
+  //! Re-reads the mask of every input port into the mask bitset & port totals (e.g. at FSM transitions)
+  void updatePortMask();
+
+  //! Makes all of the board's values due to be re-read in the next monitoring cycle; called by commands that change the board's state
+  void expireRefreshTimers();
+
+  //! Applies the board's settings from the gatekeeper of the engaged configuration key (e.g. refresh periods, write verification,
+  //! the parameters of configureBlocks' branches); called by the cell
+  void engage(const swatch::action::GateKeeper& aGateKeeper);
+
+  //! Which input ports are masked, as of the last updatePortMask()
+  const DummyPortMask& getPortMask() const
+  {
+    return *mPortMask;
+  }
+
 protected:
   virtual void retrieveMetricValues();
 
 private:
   boost::scoped_ptr<DummyProcDriver> mDriver;
+  boost::scoped_ptr<DummyProcStatusCache> mStatusCache;
+  boost::scoped_ptr<DummyPortAggregator> mPortAggregator;
+  boost::scoped_ptr<DummyPortMask> mPortMask;
+  boost::optional<uint64_t> mFirmwareVersion;
+  DummyRefreshTimer mFirmwareVersionTimer;
+
+  //! One per part of the status block, so that an unreachable part doesn't stop the rest of the board from being polled
+  DummyCircuitBreaker mCircuitBreakers[DummyProcDriver::kNumStatusBlockParts];
+  //! Whether any part's breaker is open; the largest number of consecutive failures, summed trips, and longest backoff over the parts
+  swatch::core::SimpleMetric<bool>& mMetricCircuitBreakerOpen;
+  swatch::core::SimpleMetric<uint32_t>& mMetricConsecutiveFailures;
+  swatch::core::SimpleMetric<uint32_t>& mMetricCircuitBreakerTrips;
+  swatch::core::SimpleMetric<float>& mMetricPollingBackoff;
+
+  DummyRefreshTimerSet mRefreshTimers;
 };
 
 
@@ -12,6 +12,7 @@
 
 #include "rpcos4ph2/dummy/AbstractConfigureCommand.hpp"
 #include "rpcos4ph2/dummy/AbstractForceStateCommand.hpp"
+#include "rpcos4ph2/dummy/DummyPortIdList.hpp"
 
 
 namespace rpcos4ph2 {
@@ -43,6 +44,11 @@ public:
 
 private:
   void runAction(bool aErrorOccurs);
+
+  uint64_t getAppliedConfiguration();
+
+  std::vector<bool> mIncludedPorts;
+  DummyPortIdList mPortIds;
 };
 
 class DummyConfigureRxCommand : public AbstractConfigureCommand {
@@ -52,6 +58,13 @@ public:
 
 private:
   void runAction(bool aErrorOccurs);
+
+  uint64_t hashInputs(uint64_t aHash);
+
+  uint64_t getAppliedConfiguration();
+
+  std::vector<bool> mIncludedPorts;
+  DummyPortIdList mPortIds;
 };
 
 
@@ -62,6 +75,8 @@ public:
 
 private:
   void runAction(bool aErrorOccurs);
+
+  uint64_t getAppliedConfiguration();
 };
 
 
@@ -72,6 +87,8 @@ public:
 
 private:
   void runAction(bool aErrorOccurs);
+
+  uint64_t getAppliedConfiguration();
 };
 
 
@@ -3,13 +3,16 @@
 #define _RPCOS4PH2_DUMMY_DUMMYREADOUT_HPP__
 
 
+#include "rpcos4ph2/dummy/DummyChangeTracker.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
 #include "swatch/processor/ReadoutInterface.hpp"
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
-class DummyProcDriver;
+class DummyProcStatusCache;
 
 /**
  * @class DummyReadoutInterface
@@ -17,14 +20,22 @@ class DummyProcDriver;
  */
 class DummyReadoutInterface : public swatch::processor::ReadoutInterface {
 public:
-  DummyReadoutInterface(DummyProcDriver& aDriver);
+  DummyReadoutInterface(DummyProcStatusCache& aStatusCache);
 
   virtual ~DummyReadoutInterface();
 
   virtual void retrieveMetricValues();
 
+  //! True if the status changed, or couldn't be read, in the latest metric update
+  bool isDirty() const;
+
+  //! Controls how often the values are re-read from the hardware
+  DummyRefreshTimer& getRefreshTimer();
+
 private:
-  DummyProcDriver& mDriver;
+  DummyProcStatusCache& mStatusCache;
+  DummyChangeTracker<DummyProcDriver::ReadoutStatus> mChangeTracker;
+  DummyRefreshTimer mRefreshTimer;
 };
 
 } // namespace dummy
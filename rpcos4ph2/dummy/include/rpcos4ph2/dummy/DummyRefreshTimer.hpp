@@ -0,0 +1,92 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYREFRESHTIMER_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYREFRESHTIMER_HPP__
+
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/chrono.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+//! Decides whether a monitorable object's values are due to be re-read from the hardware, based on its refresh period
+class DummyRefreshTimer {
+public:
+  DummyRefreshTimer();
+
+  ~DummyRefreshTimer();
+
+  //! Sets the refresh period; a period of 0 means that values are re-read in every monitoring cycle
+  void setPeriod(const boost::chrono::milliseconds& aPeriod);
+
+  const boost::chrono::milliseconds& getPeriod() const;
+
+  //! Returns true (and restarts the period) if the values haven't been read since the start of the current period
+  bool isDue();
+
+  //! Makes the values due to be re-read in the next monitoring cycle; can be called from any thread (e.g. by commands)
+  void expire();
+
+private:
+  boost::chrono::milliseconds mPeriod;
+  std::atomic<bool> mExpired;
+  boost::chrono::steady_clock::time_point mLastRefresh;
+};
+
+
+class DummyMonitoringSchedule;
+
+//! The refresh timers of a board's monitorable objects & metrics, whose periods follow the engaged schedule & the board's FSM state
+class DummyRefreshTimerSet {
+public:
+  //! Until a schedule is engaged, values are re-read in every cycle
+  DummyRefreshTimerSet();
+
+  ~DummyRefreshTimerSet();
+
+  //! Adds a timer, whose period is that of the object/metric at aPath (relative to the board)
+  void add(const std::string& aPath, DummyRefreshTimer& aTimer);
+
+  //! Reads the schedule from the gatekeeper in the board's contexts (see DummyMonitoringSchedule); it's applied from the next call to update.
+  //! Can be called from any thread (e.g. by the cell, once the configuration key is known)
+  void engage(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts);
+
+  //! Re-reads the timers' periods if a schedule has been engaged or the FSM state has changed since the last call; called each monitoring cycle
+  void update(const std::string& aState);
+
+  //! Makes all values due to be re-read in the next monitoring cycle (e.g. after a command changes the board's state)
+  void expire();
+
+private:
+  std::vector<std::pair<std::string, DummyRefreshTimer*> > mTimers;
+  bool mUpdated;
+  std::string mState;
+
+  boost::mutex mScheduleMutex;
+  boost::shared_ptr<const DummyMonitoringSchedule> mSchedule;
+  //! True if a schedule has been engaged since the last call to update
+  bool mScheduleChanged;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYREFRESHTIMER_HPP__ */
@@ -0,0 +1,166 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYREGISTERMAP_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYREGISTERMAP_HPP__
+
+
+#include <stdint.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/thread/shared_mutex.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyRegisterMap
+ * @brief Simulated 32-bit word-addressed register/memory space, used as the 'hardware' behind the dummy drivers
+ *
+ * The backing store is an anonymous memory mapping, so pages are only allocated (zero-filled) by the kernel
+ * when first accessed; resident memory scales with the registers that are actually used.
+ *
+ * Each access counts as one round-trip to the board (a masked write counts as two, since it reads the word first),
+ * except for batches, which emulate a single packet of block writes and read-modify-writes.
+ *
+ * Registers may be accessed from several threads (e.g. by the monitoring sweep while a command runs): each access
+ * (including a masked write, and a whole batch) is atomic with respect to the others, so a block read never sees a
+ * partially-written batch.
+ */
+class DummyRegisterMap {
+public:
+  //! Named register, i.e. a masked field of the word at a given address
+  struct Register {
+    Register(uint32_t aAddress, uint32_t aMask = 0xFFFFFFFF);
+    uint32_t address;
+    uint32_t mask;
+  };
+
+  //! Write to a word in a batch; only the bits in the mask are changed, with the value already shifted into place
+  struct MaskedWord {
+    MaskedWord(uint32_t aAddress, uint32_t aValue, uint32_t aMask = 0xFFFFFFFF);
+    //! Write to a register's field; aValue is shifted up to the mask's lowest set bit
+    MaskedWord(const Register& aRegister, uint32_t aValue);
+    uint32_t address;
+    uint32_t value;
+    uint32_t mask;
+  };
+
+  //! Adds the round-trips made by the calling thread (to any register map) to a count while in scope, e.g. to the count of the
+  //! command execution whose step is running, so that each execution gets its own round-trips whichever thread runs it;
+  //! scopes can be nested, and round-trips are then only counted by the innermost one
+  class RoundTripScope {
+  public:
+    explicit RoundTripScope(uint32_t& aCount);
+    ~RoundTripScope();
+
+  private:
+    RoundTripScope(const RoundTripScope&);
+    RoundTripScope& operator=(const RoundTripScope&);
+
+    uint32_t* const mPreviousCount;
+  };
+
+  //! Number of transactions and words transferred since construction (or last reset of the counters); a snapshot, since the
+  //! registers may be accessed from several threads (e.g. by the monitoring sweep while a command runs)
+  struct Counters {
+    Counters();
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t blockReads;
+    uint64_t blockWrites;
+    uint64_t wordsRead;
+    uint64_t wordsWritten;
+    uint64_t roundTrips;
+  };
+
+  explicit DummyRegisterMap(size_t aSizeInBytes);
+
+  ~DummyRegisterMap();
+
+  //! Size of the address space, in 32-bit words
+  size_t size() const;
+
+  //! Number of bytes of the backing store that are currently resident in memory
+  size_t getResidentBytes() const;
+
+  void addRegister(const std::string& aName, const Register& aRegister);
+
+  const Register& getRegister(const std::string& aName) const;
+
+  uint32_t read(uint32_t aAddress) const;
+
+  //! Reads a masked field; the returned value is shifted down to the mask's lowest set bit
+  uint32_t read(const Register& aRegister) const;
+
+  uint32_t read(const std::string& aName) const;
+
+  void write(uint32_t aAddress, uint32_t aValue);
+
+  //! Masked read-modify-write; aValue is shifted up to the mask's lowest set bit
+  void write(const Register& aRegister, uint32_t aValue);
+
+  void write(const std::string& aName, uint32_t aValue);
+
+  void readBlock(uint32_t aAddress, size_t aNrWords, uint32_t* aData) const;
+
+  void writeBlock(uint32_t aAddress, size_t aNrWords, const uint32_t* aData);
+
+  //! Writes the same value to a contiguous block of words, in a single transaction
+  void fillBlock(uint32_t aAddress, size_t aNrWords, uint32_t aValue);
+
+  //! Writes a batch of words (sorted by address, at most one per address) in a single round-trip; each contiguous run counts as a block write
+  void writeBatch(const std::vector<MaskedWord>& aWords);
+
+  //! Reads the words at the addresses in a batch (e.g. to verify it) in a single round-trip
+  void readBatch(const std::vector<MaskedWord>& aWords, std::vector<uint32_t>& aValues) const;
+
+  Counters getCounters() const;
+
+  void resetCounters();
+
+  //! Extracts a register's field from the value of its word (e.g. from the result of a block read)
+  static uint32_t getField(uint32_t aWord, const Register& aRegister);
+
+private:
+  DummyRegisterMap(const DummyRegisterMap&);
+  DummyRegisterMap& operator=(const DummyRegisterMap&);
+
+  void checkRange(uint32_t aAddress, size_t aNrWords) const;
+
+  void countRoundTrip() const;
+
+  static uint32_t getShift(uint32_t aMask);
+
+  //! Live counterparts of the Counters fields, updated atomically
+  struct AtomicCounters {
+    AtomicCounters();
+    void reset();
+    std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> writes;
+    std::atomic<uint64_t> blockReads;
+    std::atomic<uint64_t> blockWrites;
+    std::atomic<uint64_t> wordsRead;
+    std::atomic<uint64_t> wordsWritten;
+    std::atomic<uint64_t> roundTrips;
+  };
+
+  //! Unguarded accessors for a word of the backing store; mBufferMutex must be locked by caller
+  uint32_t loadWord(uint32_t aAddress) const;
+  void storeWord(uint32_t aAddress, uint32_t aValue);
+
+  uint8_t* mBuffer;
+  size_t mSizeInBytes;
+  //! Guards the contents of the backing store: shared for reads, exclusive for writes
+  mutable boost::shared_mutex mBufferMutex;
+  std::map<std::string, Register> mRegisters;
+  mutable AtomicCounters mCounters;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYREGISTERMAP_HPP__ */
@@ -0,0 +1,68 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYREGISTERTRANSACTION_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYREGISTERTRANSACTION_HPP__
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "rpcos4ph2/dummy/DummyRegisterMap.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyRegisterTransaction
+ * @brief Write-combining buffer for a register map: writes are staged, then sent to the board in a single round-trip
+ *
+ * Staged writes to the same word are merged (later writes winning, field by field), so a register written several
+ * times, or several fields of the same word, cost one word in the batch; masked writes don't need a read beforehand.
+ * On commit, the words are sorted into contiguous runs and written as one batch, optionally followed by a second
+ * round-trip that reads them back to verify them. Writes aren't visible in the register map until committed.
+ *
+ * The buffer keeps its capacity between commits, so a driver can reuse one transaction for all of its configuration.
+ */
+class DummyRegisterTransaction {
+public:
+  explicit DummyRegisterTransaction(DummyRegisterMap& aRegisters);
+
+  //! Discards any writes that haven't been committed
+  ~DummyRegisterTransaction();
+
+  void write(uint32_t aAddress, uint32_t aValue);
+
+  //! Masked write; aValue is shifted up to the mask's lowest set bit
+  void write(const DummyRegisterMap::Register& aRegister, uint32_t aValue);
+
+  //! Writes the same value to a contiguous block of words
+  void fill(uint32_t aAddress, size_t aNrWords, uint32_t aValue);
+
+  //! Writes the staged words in a single round-trip; if aVerify is true, reads them back, throwing if any differ
+  void commit(bool aVerify);
+
+  void discard();
+
+  //! Number of writes staged since the last commit, before merging writes to the same word
+  size_t getNumStagedWrites() const;
+
+private:
+  DummyRegisterTransaction(const DummyRegisterTransaction&);
+  DummyRegisterTransaction& operator=(const DummyRegisterTransaction&);
+
+  //! Sorts the staged words by address, and merges writes to the same word
+  void coalesce();
+
+  DummyRegisterMap& mRegisters;
+  std::vector<DummyRegisterMap::MaskedWord> mWords;
+  //! Scratch buffer for read-back verification
+  std::vector<uint32_t> mReadBack;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYREGISTERTRANSACTION_HPP__ */
+
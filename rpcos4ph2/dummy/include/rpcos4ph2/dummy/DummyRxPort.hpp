@@ -5,6 +5,9 @@
 
 #include <string>
 
+#include "rpcos4ph2/dummy/DummyChangeTracker.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
 #include "swatch/processor/Port.hpp"
 
 
@@ -12,21 +15,39 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
-class DummyProcDriver;
+class DummyPortAggregator;
+class DummyPortMask;
+class DummyProcStatusCache;
 
 //! Dummy input port implementation (used for testing)
 class DummyRxPort : public swatch::processor::InputPort {
 public:
-  DummyRxPort(const std::string& aId, uint32_t aNumber, DummyProcDriver& aDriver);
+  //! aIndex is the port's position in the processor's input port collection
+  DummyRxPort(const std::string& aId, uint32_t aNumber, size_t aIndex, DummyProcStatusCache& aStatusCache, DummyPortAggregator& aAggregator, DummyPortMask& aPortMask);
 
   virtual ~DummyRxPort();
 
   virtual void retrieveMetricValues();
 
+  size_t getIndex() const;
+
+  //! True if the status changed, or couldn't be read, in the latest metric update
+  bool isDirty() const;
+
+  //! Controls how often the values are re-read from the hardware
+  DummyRefreshTimer& getRefreshTimer();
+
 private:
   uint32_t mChannelId;
-  DummyProcDriver& mDriver;
+  size_t mIndex;
+  DummyProcStatusCache& mStatusCache;
+  DummyPortAggregator& mAggregator;
+  DummyPortMask& mPortMask;
   swatch::core::SimpleMetric<bool>& mWarningSign;
+  DummyChangeTracker<DummyProcDriver::RxPortStatus> mChangeTracker;
+  //! Which of the locked, aligned & CRC error metrics (bits 0 to 2) count towards the port being in error, as of the last update
+  uint32_t mErrorCriteria;
+  DummyRefreshTimer mRefreshTimer;
 };
 
 
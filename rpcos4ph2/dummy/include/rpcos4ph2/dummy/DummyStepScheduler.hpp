@@ -0,0 +1,77 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYSTEPSCHEDULER_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYSTEPSCHEDULER_HPP__
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <queue>
+#include <vector>
+
+#include "boost/chrono.hpp"
+#include "boost/function.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+#include "boost/thread/thread.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyStepScheduler
+ * @brief Small, process-wide pool of threads that runs the steps of the dummy boards' commands
+ *
+ * Each step is a short task. A command that has to wait before its next step queues that step for the time it's due,
+ * rather than sleeping on a thread, so that a few threads can drive the commands of many boards at once. Tasks run in
+ * order of due time, and then in the order they were posted. Tasks mustn't block, since that would hold up the other
+ * boards' steps.
+ */
+class DummyStepScheduler {
+public:
+  ~DummyStepScheduler();
+
+  //! Returns the process-wide scheduler, whose threads are started on first use (one per core)
+  static DummyStepScheduler& get();
+
+  //! Queues the task to run as soon as a thread is free
+  void post(const boost::function<void ()>& aTask);
+
+  //! Queues the task to run once the given time has passed
+  void postAt(const boost::chrono::steady_clock::time_point& aTime, const boost::function<void ()>& aTask);
+
+  size_t getNumThreads() const;
+
+private:
+  explicit DummyStepScheduler(size_t aNumThreads);
+
+  DummyStepScheduler(const DummyStepScheduler&);
+  DummyStepScheduler& operator=(const DummyStepScheduler&);
+
+  void runWorker();
+
+  struct Task {
+    boost::chrono::steady_clock::time_point time;
+    uint64_t sequence;
+    boost::function<void ()> function;
+  };
+
+  //! Orders the queue so that the earliest task is on top (ties in order of posting)
+  struct IsLater {
+    bool operator()(const Task& aTask1, const Task& aTask2) const;
+  };
+
+  std::priority_queue<Task, std::vector<Task>, IsLater> mTasks;
+  uint64_t mNextSequence;
+  bool mStopping;
+  boost::mutex mMutex;
+  boost::condition_variable mCondition;
+  boost::thread_group mThreads;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYSTEPSCHEDULER_HPP__ */
@@ -8,9 +8,24 @@
 #ifndef _RPCOS4PH2_DUMMY_DUMMYSYSTEM_HPP__
 #define _RPCOS4PH2_DUMMY_DUMMYSYSTEM_HPP__
 
+#include <vector>
+
+#include "boost/chrono.hpp"
+#include "boost/scoped_ptr.hpp"
+
 #include "swatch/system/System.hpp"
 #include "swatch/action/SystemStateMachine.hpp"
 
+#include "rpcos4ph2/dummy/DummyBoardBuilder.hpp"
+#include "rpcos4ph2/dummy/DummyTransitionGraph.hpp"
+
+namespace swatch
+{
+    namespace action
+    {
+        class GateKeeper;
+    }
+}
 
 namespace rpcos4ph2
 {
@@ -21,15 +36,58 @@ namespace rpcos4ph2
     namespace dummy
     {
 
-        class DummySystem : public swatch::system::System
+        class DummyMonitoringSweep;
+
+        //! Boards' components are prebuilt by the DummyBoardBuilder::Scope base class, which is constructed before the system
+        class DummySystem : private DummyBoardBuilder::Scope, public swatch::system::System
         {
         public:
             DummySystem(const swatch::core::AbstractStub &aStub);
             ~DummySystem();
 
+            //! Applies the dummy boards' settings (e.g. monitoring refresh periods) from the gatekeeper of the configuration key;
+            //! called by the cell once the key is known, i.e. after the setup & configure transitions
+            void engage(const swatch::action::GateKeeper &aGateKeeper);
+
+        protected:
+            //! Reports the critical path of each transition that has finished since the previous cycle, and publishes the
+            //! summary of the latest monitoring sweep
+            virtual void retrieveMetricValues();
+
         private:
-            static std::string analyseSourceOfWarning(const swatch::action::SystemTransitionSnapshot &);
-            static std::string analyseSourceOfError(const swatch::action::SystemTransitionSnapshot &);
+            //! Creates the monitoring sweep over the processors & AMC13s, and attaches it to their status caches, so that each
+            //! board's hardware reads are bounded by the sweep's deadline. Number of threads & deadline are set from the
+            //! gatekeeper's 'monitoringThreads' & 'monitoringDeadline' (ms) parameters once engaged
+            void setUpMonitoringSweep();
+
+            std::string analyseSourceOfWarning(const swatch::action::SystemTransitionSnapshot &) const;
+            std::string analyseSourceOfError(const swatch::action::SystemTransitionSnapshot &) const;
+
+            //! Returns the transition's critical path as a one-line summary
+            std::string getCriticalPath(const swatch::action::SystemTransitionSnapshot &aSystemSnapshot) const;
+
+            //! Logs the critical path of each run-control transition that has finished since the previous call
+            void reportCompletedTransitions();
+
+            //! The latest execution of a run-control transition that has been reported
+            struct ReportedTransition
+            {
+                const swatch::action::SystemTransition *transition;
+                swatch::action::Functionoid::State state;
+                float runningTime;
+            };
+
+            DummyTransitionGraph mTransitionGraph;
+            std::vector<ReportedTransition> mReportedTransitions;
+
+            size_t mMonitoringThreads;
+            boost::chrono::milliseconds mMonitoringDeadline;
+            boost::scoped_ptr<DummyMonitoringSweep> mMonitoringSweep;
+            swatch::core::SimpleMetric<float> &mMetricSweepTime;
+            swatch::core::SimpleMetric<float> &mMetricBoardLatencyMedian;
+            swatch::core::SimpleMetric<float> &mMetricBoardLatency90thPercentile;
+            swatch::core::SimpleMetric<float> &mMetricBoardLatencyMax;
+            swatch::core::SimpleMetric<uint32_t> &mMetricBoardsOverdue;
         };
 
     } // namespace dummy
@@ -3,26 +3,37 @@
 #define _RPCOS4PH2_DUMMY_DUMMYTTC_HPP__
 
 
+#include "rpcos4ph2/dummy/DummyChangeTracker.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
 #include "swatch/processor/TTCInterface.hpp"
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
-class DummyProcDriver;
+class DummyProcStatusCache;
 
 //! Dummy TTC interface implementation (used for testing)
 class DummyTTC : public swatch::processor::TTCInterface {
 public:
-  DummyTTC(DummyProcDriver& aDriver);
+  DummyTTC(DummyProcStatusCache& aStatusCache);
 
   virtual ~DummyTTC();
 
+  //! True if the status changed, or couldn't be read, in the latest metric update
+  bool isDirty() const;
+
+  //! Controls how often the values are re-read from the hardware
+  DummyRefreshTimer& getRefreshTimer();
+
 private:
   virtual void retrieveMetricValues();
 
-  DummyProcDriver& mDriver;
+  DummyProcStatusCache& mStatusCache;
   swatch::core::SimpleMetric<bool>& mWarningSign;
+  DummyChangeTracker<DummyProcDriver::TTCStatus> mChangeTracker;
+  DummyRefreshTimer mRefreshTimer;
 };
 
 } // namespace dummy
@@ -0,0 +1,63 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYTRANSITIONANALYSIS_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYTRANSITIONANALYSIS_HPP__
+
+
+#include <stddef.h>
+#include <ostream>
+#include <vector>
+
+#include "swatch/action/Functionoid.hpp"
+
+
+namespace swatch {
+namespace action {
+class CommandSnapshot;
+class SystemTransitionSnapshot;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyTransitionAnalysis
+ * @brief Summary of the commands run in a system transition, gathered in a single pass over its snapshot
+ *
+ * Commands that ended in warning or error are referenced rather than copied, so the analysis mustn't outlive the
+ * snapshot; nothing is formatted until the analysis is written to a stream.
+ */
+class DummyTransitionAnalysis {
+public:
+  explicit DummyTransitionAnalysis(const swatch::action::SystemTransitionSnapshot& aSnapshot);
+
+  ~DummyTransitionAnalysis();
+
+  //! Number of commands run that ended in the given state (only kDone, kWarning & kError are counted)
+  size_t getNumCommands(swatch::action::Functionoid::State aState) const;
+
+  //! Commands that ended in the given state (only kWarning & kError are recorded), in the order that they ran
+  const std::vector<const swatch::action::CommandSnapshot*>& getCommands(swatch::action::Functionoid::State aState) const;
+
+  //! Sum of the running times of all commands, in seconds
+  float getTotalCommandTime() const;
+
+  //! Writes the boards & commands that ended in the given state, with their running times, e.g. "2 boards/commands ... procA:cfgRx (1.5s), ..."
+  void writeCommands(std::ostream& aStream, swatch::action::Functionoid::State aState) const;
+
+private:
+  size_t mNumDone;
+  size_t mNumWarning;
+  size_t mNumError;
+  float mTotalCommandTime;
+  std::vector<const swatch::action::CommandSnapshot*> mWarnings;
+  std::vector<const swatch::action::CommandSnapshot*> mErrors;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYTRANSITIONANALYSIS_HPP__ */
+
@@ -0,0 +1,83 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYTRANSITIONGRAPH_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYTRANSITIONGRAPH_HPP__
+
+
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace swatch {
+namespace action {
+class SystemTransitionSnapshot;
+}
+}
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyTransitionGraph
+ * @brief Dependencies between the per-board transitions of a system transition, used to find its critical path
+ *
+ * The system runs each step of a transition on all boards, and waits for every board before starting the next step.
+ * However, a board's transition only really depends on the earlier transitions of its own board and of the other
+ * boards in its crate (e.g. a processor needs its crate's AMC13 clock, not every AMC13 clock). From the running times
+ * in a transition's snapshot, this graph estimates the time that the transition would take if each board started as soon
+ * as those prerequisites had finished, along with the chain of boards that gated its completion.
+ *
+ * This is a report only: the transitions are still run by SWATCH's SystemTransition, which starts each step on all of its
+ * boards and waits for all of them, and the boards' transitions can only be run through it. Running each board's next
+ * transition as soon as its prerequisites have finished would need an executor in SWATCH itself, so the estimate shows
+ * what such an executor would gain on this system.
+ */
+class DummyTransitionGraph {
+public:
+  //! A board's transition within one step of a system transition
+  struct Node {
+    size_t step;
+    std::string boardId;
+    std::string transitionId;
+    float runningTime;
+    //! Earliest time that this board's transition could finish, given its prerequisites
+    float finishTime;
+  };
+
+  struct Report {
+    //! Running time of the transition with a barrier after each step (i.e. the sum of the slowest board in each step)
+    float barrierTime;
+    //! Estimated running time of the transition if boards only waited for the prerequisites in their own crate
+    float estimatedDependencyTime;
+    //! Board transitions that gated completion, in the order that they ran
+    std::vector<Node> criticalPath;
+  };
+
+  DummyTransitionGraph();
+
+  ~DummyTransitionGraph();
+
+  //! Declares the crate that a board is in; boards in the same crate depend on each others' earlier steps
+  void addBoard(const std::string& aBoardId, const std::string& aCrateId);
+
+  //! Finds the critical path of the transition from its snapshot; boards excluded from the transition are skipped
+  void analyse(const swatch::action::SystemTransitionSnapshot& aSnapshot, Report& aReport) const;
+
+  //! Formats the report as a single line, e.g. for the log or a transition's warning/error message
+  static std::string format(const Report& aReport);
+
+private:
+  //! True if aBoard's transition depends on aOtherBoard's transition in an earlier step; boards with unknown crates depend on all boards
+  bool dependsOn(const std::string& aBoard, const std::string& aOtherBoard) const;
+
+  std::map<std::string, std::string> mCrates;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYTRANSITIONGRAPH_HPP__ */
+
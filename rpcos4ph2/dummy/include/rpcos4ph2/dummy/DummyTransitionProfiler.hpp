@@ -0,0 +1,178 @@
+#ifndef _RPCOS4PH2_DUMMY_DUMMYTRANSITIONPROFILER_HPP__
+#define _RPCOS4PH2_DUMMY_DUMMYTRANSITIONPROFILER_HPP__
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "boost/chrono.hpp"
+#include "boost/scoped_array.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "swatch/action/Functionoid.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+/**
+ * @class DummyTransitionProfiler
+ * @brief Records the start and end time of each command that the boards run in run-control transitions
+ *
+ * Commands are recorded into a fixed-size ring buffer without taking any locks, so that the boards' threads don't
+ * contend with each other (or with an export) while running a transition; once the buffer is full, the oldest records
+ * are overwritten. Each record is written under a per-slot sequence number, and a reader discards any slot that is
+ * being written while it is read. The boards' and commands' IDs are registered once, when each command is constructed
+ * (a board's command that is constructed again, e.g. when the system is rebuilt, reuses its earlier registration).
+ *
+ * Each record is tagged with the run-control transition that was in progress when the command started; the cell marks
+ * the start of each transition, and exports (then clears) the records once the transition has finished.
+ *
+ * Each record also holds the number of register round-trips that the command made to its board (as counted by the
+ * command, since its steps may run on different threads), which the summary adds up per board and per transition. A
+ * command that runs others within it (e.g. the branches of a fork/join command) includes their round-trips in its own,
+ * so the records of the nested commands aren't added up again.
+ *
+ * The records can be exported as a Chrome trace (for chrome://tracing or Perfetto), with one row per board, or as a
+ * per-board summary. The queueing delay of a command is the time from when it was scheduled (i.e. when SWATCH or its
+ * fork/join command started it) until its first step ran, e.g. while waiting for a thread of the step scheduler, or
+ * for the branches that it depends on.
+ */
+class DummyTransitionProfiler {
+public:
+  //! A command's execution, as exported from the ring buffer; times are in microseconds since the profiler was created
+  struct Record {
+    //! Empty if the command was run outside of a run-control transition
+    std::string transitionId;
+    std::string boardId;
+    std::string commandId;
+    int64_t scheduledTime;
+    int64_t startTime;
+    int64_t endTime;
+    //! Time from when the command was scheduled until it started
+    int64_t queueingDelay;
+    swatch::action::Functionoid::State state;
+    uint32_t roundTrips;
+    //! True if the command ran within another one, which includes its round-trips
+    bool nested;
+  };
+
+  //! Records the command's execution from construction (i.e. when it's scheduled) until destruction, possibly on another
+  //! thread; the state is kError unless set beforehand
+  class Scope {
+  public:
+    Scope(uint32_t aCommandIndex, bool aNested = false);
+
+    ~Scope();
+
+    void setState(swatch::action::Functionoid::State aState);
+
+    //! Marks the start of the command's first step; a command that never starts is recorded as starting when scheduled
+    void markStarted();
+
+    //! Adds to the number of register round-trips made by the command
+    void addRoundTrips(uint32_t aNumRoundTrips);
+
+    uint32_t getNumRoundTrips() const;
+
+  private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+
+    const uint32_t mCommandIndex;
+    const uint32_t mTransitionIndex;
+    const bool mNested;
+    const int64_t mScheduledTime;
+    int64_t mStartTime;
+    uint32_t mNumRoundTrips;
+    swatch::action::Functionoid::State mState;
+  };
+
+  ~DummyTransitionProfiler();
+
+  //! Returns the process-wide profiler, shared by all boards
+  static DummyTransitionProfiler& get();
+
+  //! Registers a board's command, returning the index that its records refer to; the same index is returned if it's already registered
+  uint32_t registerCommand(const std::string& aBoardId, const std::string& aCommandId);
+
+  //! Tags the commands that start from now on with the transition (an empty ID ends the tagging)
+  void beginTransition(const std::string& aTransitionId);
+
+  //! Index of the transition that commands starting now are tagged with
+  uint32_t getCurrentTransition() const;
+
+  //! Adds a record to the ring buffer (lock-free)
+  void record(uint32_t aCommandIndex, uint32_t aTransitionIndex, int64_t aScheduledTime, int64_t aStartTime, int64_t aEndTime, swatch::action::Functionoid::State aState, uint32_t aRoundTrips, bool aNested);
+
+  //! Microseconds since the profiler was created
+  int64_t now() const;
+
+  //! Copies the complete records in the ring buffer, ordered by start time
+  void getRecords(std::vector<Record>& aRecords) const;
+
+  //! Number of records added since the profiler was created (or last cleared), including those since overwritten
+  uint64_t getNumRecorded() const;
+
+  //! Discards all records, e.g. once they have been exported at the end of a transition
+  void clear();
+
+  //! Writes the records in Chrome's trace event format (JSON), with one row per board; each command's transition is in its arguments
+  void writeChromeTrace(std::ostream& aStream) const;
+
+  //! Writes a summary for each transition, with its total number of commands & register round-trips, then per board: number
+  //! of commands, busy time, queueing delay, register round-trips (excluding those of nested commands, which are already
+  //! included in their parent's), and the slowest command
+  void writeSummary(std::ostream& aStream) const;
+
+  //! Number of records held in the ring buffer
+  static const size_t kCapacity;
+
+private:
+  DummyTransitionProfiler();
+
+  struct Slot {
+    //! Odd while the slot is being written; 2*(N+1) once the slot holds record number N
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint32_t> command;
+    std::atomic<uint32_t> transition;
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> roundTrips;
+    std::atomic<bool> nested;
+    std::atomic<int64_t> scheduledTime;
+    std::atomic<int64_t> startTime;
+    std::atomic<int64_t> endTime;
+  };
+
+  struct CommandInfo {
+    std::string boardId;
+    std::string commandId;
+  };
+
+  const boost::chrono::steady_clock::time_point mEpoch;
+  boost::scoped_array<Slot> mSlots;
+  std::atomic<uint64_t> mNextRecord;
+  //! Records before this number were cleared
+  std::atomic<uint64_t> mFirstRecord;
+
+  std::atomic<uint32_t> mCurrentTransition;
+
+  //! Only used when commands or transitions are registered, or records exported, not when recording
+  mutable boost::mutex mCommandsMutex;
+  std::vector<CommandInfo> mCommands;
+  //! IDs of the transitions that records are tagged with; index 0 is outside of any transition
+  std::vector<std::string> mTransitions;
+};
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
+
+#endif /* _RPCOS4PH2_DUMMY_DUMMYTRANSITIONPROFILER_HPP__ */
+
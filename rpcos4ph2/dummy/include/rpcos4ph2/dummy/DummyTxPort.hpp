@@ -3,6 +3,9 @@
 #define _RPCOS4PH2_DUMMY_DUMMYTXPORT_HPP__
 
 
+#include "rpcos4ph2/dummy/DummyChangeTracker.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
 #include "swatch/processor/Port.hpp"
 
 
@@ -10,20 +13,28 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
-class DummyProcDriver;
+class DummyProcStatusCache;
 
 //! Dummy output port implementation (used for testing)
 class DummyTxPort : public swatch::processor::OutputPort {
 public:
-  DummyTxPort (const std::string& aId, uint32_t aNumber, DummyProcDriver& aDriver);
+  DummyTxPort (const std::string& aId, uint32_t aNumber, DummyProcStatusCache& aStatusCache);
   virtual ~DummyTxPort ();
 
   virtual void retrieveMetricValues();
 
+  //! True if the status changed, or couldn't be read, in the latest metric update
+  bool isDirty() const;
+
+  //! Controls how often the values are re-read from the hardware
+  DummyRefreshTimer& getRefreshTimer();
+
 private:
   uint32_t mChannelId;
-  DummyProcDriver& mDriver;
+  DummyProcStatusCache& mStatusCache;
   swatch::core::SimpleMetric<bool>& mWarningSign;
+  DummyChangeTracker<DummyProcDriver::TxPortStatus> mChangeTracker;
+  DummyRefreshTimer mRefreshTimer;
 };
 
 
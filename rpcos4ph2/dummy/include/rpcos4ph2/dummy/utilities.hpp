@@ -4,6 +4,7 @@
 
 
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 #include "swatch/action/ActionableObject.hpp"
@@ -11,6 +12,13 @@
 #include "swatch/core/MetricSnapshot.hpp"
 
 
+namespace swatch {
+namespace action {
+class GateKeeper;
+}
+}
+
+
 namespace rpcos4ph2 {
 
 // forward declarations
@@ -26,10 +34,24 @@ bool filterOutMaskedPorts(const swatch::core::MonitorableObject& aObj);
 
 bool filterOutDisabledActionables(const swatch::core::MonitorableObject& aObj);
 
+//! Sums the values of the snapshots into aSum, without allocating; returns false if any value is unknown
+bool calculateSum(const std::vector<swatch::core::MetricSnapshot>& aSnapshots, uint32_t& aSum);
+
+//! Counts the snapshots in error into aCount, without allocating; returns false if any status is unknown
+bool calculateNumberInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& aSnapshots, uint32_t& aCount);
+
+//! ComplexMetric adapter for calculateSum (SWATCH takes ownership of the returned value)
 const uint32_t* sumUpCRCErrors(const std::vector<swatch::core::MetricSnapshot>& aSnapshots);
 
+//! ComplexMetric adapter for calculateNumberInError (SWATCH takes ownership of the returned value)
 const uint32_t* countObjectsInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& aSnapshots);
 
+//! Returns the resident set size of this process, in bytes (0 if it can't be determined)
+size_t getProcessResidentBytes();
+
+//! Returns the value of a board-wide boolean parameter from the gatekeeper, or aDefault if it's not set or isn't a boolean
+bool readBoolParameter(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts, const std::string& aId, bool aDefault);
+
 }
 }
 
@@ -2,19 +2,129 @@
 #include "rpcos4ph2/dummy/AbstractConfigureCommand.hpp"
 
 
+#include <algorithm>
+#include <set>
+
+#include "boost/bind.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/scoped_ptr.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/locks.hpp"
+#include "boost/thread/mutex.hpp"
+
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+#include "swatch/action/GateKeeper.hpp"
+
 #include "xdata/Boolean.h"
+#include "xdata/Serializable.h"
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger.h"
 
+#include "rpcos4ph2/dummy/DummyRegisterMap.hpp"
+#include "rpcos4ph2/dummy/DummyStepScheduler.hpp"
+#include "rpcos4ph2/dummy/DummyTransitionProfiler.hpp"
+
 
 namespace rpcos4ph2 {
 namespace dummy {
 
 
+namespace {
+
+const uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+const uint64_t kFnvPrime = 1099511628211ull;
+
+const uint32_t kDefaultDuration = 5;
+
+//! Adds the command's value of a parameter from the gatekeeper to aParams, or aDefault if there's none
+template <class T>
+void resolveParameter(const swatch::action::GateKeeper* aGateKeeper, const std::vector<std::string>& aContexts, const std::string& aCommandId, const std::string& aId, const T& aDefault, swatch::core::XParameterSet& aParams)
+{
+  const T* lValue = NULL;
+  if (aGateKeeper != NULL) {
+    const swatch::action::GateKeeper::Parameter_t lParam = aGateKeeper->get("", aCommandId, aId, aContexts);
+    lValue = dynamic_cast<const T*>(lParam.get());
+    if (lParam && (lValue == NULL))
+      LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Parameter '" << aId << "' of command '" << aCommandId << "' has the wrong type; default used");
+  }
+  aParams.add(aId, (lValue == NULL) ? aDefault : *lValue);
+}
+
+//! Outcome of an execution that a thread is waiting for
+struct Completion {
+  Completion() : finished(false) {}
+
+  void set(const AbstractConfigureCommand::Outcome& aOutcome)
+  {
+    boost::lock_guard<boost::mutex> lGuard(mutex);
+    outcome = aOutcome;
+    finished = true;
+    condition.notify_all();
+  }
+
+  bool finished;
+  AbstractConfigureCommand::Outcome outcome;
+  boost::mutex mutex;
+  boost::condition_variable condition;
+};
+
+}
+
+
+struct AbstractConfigureCommand::Execution {
+  Execution(AbstractConfigureCommand& aCommand, const Callback_t& aCallback) :
+    command(aCommand),
+    callback(aCallback),
+    plannedState(kDone),
+    throwAtEnd(false),
+    numSteps(0),
+    step(0),
+    started(false),
+    finished(false),
+    roundTrips(0)
+  {
+  }
+
+  AbstractConfigureCommand& command;
+  Callback_t callback;
+  //! State that the command ends in if it isn't cancelled (as set by the parameters)
+  State plannedState;
+  bool throwAtEnd;
+  size_t numSteps;
+  //! Steps end at fixed times from the start, so that delays in running them don't add up
+  boost::chrono::steady_clock::time_point startTime;
+  //! Index of the step to run next
+  size_t step;
+  bool started;
+  bool finished;
+  //! Register round-trips made by the execution's steps, whichever threads they ran on
+  uint32_t roundTrips;
+  Outcome outcome;
+  boost::scoped_ptr<DummyTransitionProfiler::Scope> profilerScope;
+  boost::mutex mutex;
+};
+
+
+AbstractConfigureCommand::Outcome::Outcome() :
+  state(kInitial),
+  roundTrips(0)
+{
+}
+
+
+const boost::chrono::milliseconds AbstractConfigureCommand::kStepDuration(250);
+
+
 AbstractConfigureCommand::AbstractConfigureCommand(const std::string& aId, swatch::action::ActionableObject& aActionable) :
-  Command(aId, aActionable, xdata::String("Dummy command's default result!"))
+  Command(aId, aActionable, xdata::String("Dummy command's default result!")),
+  mCancelToken(*this, aActionable.getId()),
+  mConfigurationHash(0),
+  mInlineDetails(NULL),
+  mProfilerIndex(DummyTransitionProfiler::get().registerCommand(aActionable.getId(), aId))
 {
-  registerParameter("cmdDuration", xdata::UnsignedInteger(5));
+  registerParameter("cmdDuration", xdata::UnsignedInteger(kDefaultDuration));
   registerParameter("returnWarning", xdata::Boolean(false));
   registerParameter("returnError", xdata::Boolean(false));
   registerParameter("throw", xdata::Boolean(false));
@@ -26,30 +136,222 @@ AbstractConfigureCommand::~AbstractConfigureCommand()
 }
 
 
+DummyCancelToken& AbstractConfigureCommand::getCancelToken()
+{
+  return mCancelToken;
+}
+
+
+void AbstractConfigureCommand::start(const swatch::core::XParameterSet& aParams, const Callback_t& aCallback)
+{
+  start(aParams, true, aCallback);
+}
+
+
+void AbstractConfigureCommand::resolveParameters(const swatch::action::GateKeeper* aGateKeeper, const std::vector<std::string>& aContexts, swatch::core::XParameterSet& aParams) const
+{
+  resolveParameter(aGateKeeper, aContexts, getId(), "cmdDuration", xdata::UnsignedInteger(kDefaultDuration), aParams);
+  resolveParameter(aGateKeeper, aContexts, getId(), "returnWarning", xdata::Boolean(false), aParams);
+  resolveParameter(aGateKeeper, aContexts, getId(), "returnError", xdata::Boolean(false), aParams);
+  resolveParameter(aGateKeeper, aContexts, getId(), "throw", xdata::Boolean(false), aParams);
+}
+
+
 swatch::action::Command::State AbstractConfigureCommand::code(const swatch::core::XParameterSet& aParams)
 {
-  const size_t lNrSeconds = aParams.get<xdata::UnsignedInteger>("cmdDuration").value_;
+  // Only this thread (i.e. SWATCH's) waits for the execution; its steps are run by the step scheduler
+  const Outcome lOutcome = run(aParams, false);
+  if (!lOutcome.error.empty())
+    XCEPT_RAISE(swatch::core::RuntimeError, lOutcome.error);
+  return lOutcome.state;
+}
+
+
+void AbstractConfigureCommand::start(const swatch::core::XParameterSet& aParams, bool aInline, const Callback_t& aCallback)
+{
+  const boost::shared_ptr<Execution> lExecution(new Execution(*this, aCallback));
+  boost::lock_guard<boost::mutex> lGuard(lExecution->mutex);
+  lExecution->profilerScope.reset(new DummyTransitionProfiler::Scope(mProfilerIndex, aInline));
+  mInlineDetails = aInline ? &lExecution->outcome.details : NULL;
+
+  size_t lNrSeconds = 0;
+  bool lUnchanged = false;
+  try {
+    lNrSeconds = aParams.get<xdata::UnsignedInteger>("cmdDuration").value_;
+    lExecution->throwAtEnd = aParams.get<xdata::Boolean>("throw").value_;
+    if (lExecution->throwAtEnd)
+      lExecution->plannedState = kError;
+    else if (aParams.get<xdata::Boolean>("returnError").value_)
+      lExecution->plannedState = kError;
+    else if (aParams.get<xdata::Boolean>("returnWarning").value_)
+      lExecution->plannedState = kWarning;
+
+    // Steps whose configuration (i.e. parameters, and other inputs) was last applied successfully, and whose part of the
+    // board is still in the resulting state, are skipped; the hash is never 0, since that means 'no configuration'
+    const std::set<std::string> lKeys = aParams.keys();
+    uint64_t lHash = addToHash(kFnvOffsetBasis, getId());
+    for (auto lIt = lKeys.begin(); lIt != lKeys.end(); lIt++) {
+      lHash = addToHash(lHash, *lIt);
+      lHash = addToHash(lHash, const_cast<xdata::Serializable&>(aParams.get<xdata::Serializable>(*lIt)).toString());
+    }
+    const DummyRegisterMap::RoundTripScope lRoundTripScope(lExecution->roundTrips);
+    mConfigurationHash = std::max<uint64_t>(hashInputs(lHash), 1);
+    lUnchanged = (lExecution->plannedState == kDone) && (getAppliedConfiguration() == mConfigurationHash);
+  }
+  catch (const std::exception& lException) {
+    finish(*lExecution, kError, lException.what());
+    return;
+  }
+
+  if (lUnchanged) {
+    setStatusMsg("Skipped, since the configuration is unchanged");
+    addExecutionDetails("configuration", xdata::String("skipped (unchanged)"));
+    addExecutionDetails("roundTrips", xdata::UnsignedInteger(lExecution->roundTrips));
+    finish(*lExecution, kDone, "");
+    return;
+  }
+
+  // A cancellation takes effect straight away (even if requested before the command started), by running the current step
+  // early; progress is reported as a fraction only, rather than building a message for each step
+  if (mCancelToken.isCancelled()) {
+    setStatusMsg("Cancelled before starting");
+    finish(*lExecution, kError, "");
+    return;
+  }
+  lExecution->numSteps = lNrSeconds * 4;
+  lExecution->startTime = boost::chrono::steady_clock::now();
+  setStatusMsg("Running " + boost::lexical_cast<std::string>(lExecution->numSteps) + " steps");
+
+  const boost::function<void ()> lStep = boost::bind(&AbstractConfigureCommand::runStep, lExecution);
+  DummyStepScheduler& lScheduler = DummyStepScheduler::get();
+  mCancelToken.setCallback(boost::bind(&DummyStepScheduler::post, &lScheduler, lStep));
+  lScheduler.post(lStep);
+}
+
+
+AbstractConfigureCommand::Outcome AbstractConfigureCommand::run(const swatch::core::XParameterSet& aParams, bool aInline)
+{
+  const boost::shared_ptr<Completion> lCompletion(new Completion());
+  start(aParams, aInline, boost::bind(&Completion::set, lCompletion, _1));
+
+  boost::unique_lock<boost::mutex> lLock(lCompletion->mutex);
+  while (!lCompletion->finished)
+    lCompletion->condition.wait(lLock);
+  return lCompletion->outcome;
+}
+
+
+void AbstractConfigureCommand::runStep(const boost::shared_ptr<Execution>& aExecution)
+{
+  Execution& lExecution = *aExecution;
+  AbstractConfigureCommand& lCommand = lExecution.command;
+  boost::lock_guard<boost::mutex> lGuard(lExecution.mutex);
+  if (lExecution.finished)
+    return;
+
+  if (!lExecution.started) {
+    lExecution.profilerScope->markStarted();
+    lExecution.started = true;
+  }
+
+  if (lCommand.mCancelToken.isCancelled()) {
+    lCommand.setStatusMsg("Cancelled after " + boost::lexical_cast<std::string>(lExecution.step) + " of " + boost::lexical_cast<std::string>(lExecution.numSteps) + " steps");
+    finish(lExecution, kError, "");
+    return;
+  }
+
+  if (lExecution.step < lExecution.numSteps) {
+    lCommand.setProgress(float(lExecution.step) / float(lExecution.numSteps));
+    lExecution.step++;
+    DummyStepScheduler::get().postAt(lExecution.startTime + kStepDuration * lExecution.step, boost::bind(&AbstractConfigureCommand::runStep, aExecution));
+    return;
+  }
+
+  // Last step: the action itself
+  try {
+    const DummyRegisterMap::RoundTripScope lRoundTripScope(lExecution.roundTrips);
+    lCommand.runAction(lExecution.plannedState == kError);
+  }
+  catch (const std::exception& lException) {
+    finish(lExecution, kError, lException.what());
+    return;
+  }
+  lCommand.addExecutionDetails("roundTrips", xdata::UnsignedInteger(lExecution.roundTrips));
+  finish(lExecution, lExecution.plannedState, lExecution.throwAtEnd ? "An exceptional error occurred!" : "");
+}
+
+
+void AbstractConfigureCommand::finish(Execution& aExecution, State aState, const std::string& aError)
+{
+  AbstractConfigureCommand& lCommand = aExecution.command;
+  aExecution.finished = true;
+  aExecution.outcome.state = aState;
+  aExecution.outcome.error = aError;
+  aExecution.outcome.roundTrips = aExecution.roundTrips;
+
+  aExecution.profilerScope->addRoundTrips(aExecution.roundTrips);
+  aExecution.profilerScope->setState(aState);
+  aExecution.profilerScope.reset();
+
+  // A cancellation only applies to the execution that was scheduled or running when it was requested
+  lCommand.mCancelToken.setCallback(boost::function<void ()>());
+  lCommand.mCancelToken.reset();
+  lCommand.mInlineDetails = NULL;
+
+  aExecution.callback(aExecution.outcome);
+}
+
+
+void AbstractConfigureCommand::setStatusMsg(const std::string& aMessage)
+{
+  if (mInlineDetails == NULL)
+    swatch::action::Command::setStatusMsg(aMessage);
+}
+
+
+void AbstractConfigureCommand::setProgress(float aProgress)
+{
+  if (mInlineDetails == NULL)
+    swatch::action::Command::setProgress(aProgress);
+}
+
+
+uint64_t AbstractConfigureCommand::hashInputs(uint64_t aHash)
+{
+  return aHash;
+}
+
 
-  State lState = kDone;
-  if (aParams.get<xdata::Boolean>("throw").value_)
-    lState = kError;
-  else if (aParams.get<xdata::Boolean>("returnError").value_)
-    lState = kError;
-  else if (aParams.get<xdata::Boolean>("returnWarning").value_)
-    lState = kWarning;
+uint64_t AbstractConfigureCommand::getAppliedConfiguration()
+{
+  return 0;
+}
 
-  for (size_t i=0; i<(lNrSeconds*4); i++) {
-    std::ostringstream lMsg;
-    lMsg << "Done " << i << " of " << (lNrSeconds*4) << " things";
-    setProgress(float(i)/float(lNrSeconds*4), lMsg.str());
-    boost::this_thread::sleep_for(boost::chrono::milliseconds(250));
+
+uint64_t AbstractConfigureCommand::getConfigurationHash() const
+{
+  return mConfigurationHash;
+}
+
+
+uint64_t AbstractConfigureCommand::addToHash(uint64_t aHash, const std::string& aValue)
+{
+  // FNV-1a, with a terminating null so that consecutive strings can't run into each other
+  for (size_t i = 0; i <= aValue.size(); i++) {
+    aHash ^= uint8_t((i < aValue.size()) ? aValue[i] : 0);
+    aHash *= kFnvPrime;
   }
+  return aHash;
+}
 
-  this->runAction(lState == kError);
 
-  if (aParams.get<xdata::Boolean>("throw").value_)
-    XCEPT_RAISE(swatch::core::RuntimeError,"An exceptional error occurred!");
-  return lState;
+uint64_t AbstractConfigureCommand::addToHash(uint64_t aHash, uint64_t aValue)
+{
+  for (size_t i = 0; i < sizeof(aValue); i++) {
+    aHash ^= uint8_t(aValue >> (8 * i));
+    aHash *= kFnvPrime;
+  }
+  return aHash;
 }
 
 } // end ns: dummy
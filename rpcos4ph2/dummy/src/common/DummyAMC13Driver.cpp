@@ -12,15 +12,102 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
+namespace {
+
+typedef DummyRegisterMap::Register Register_t;
+
+// Global control
+const Register_t kRegFedId(0x0000, 0xFFFF);
+const Register_t kRegRunning(0x0001, 0x1);
+
+// TTC block
+const uint32_t kAddrTTCBlock = 0x0010;
+const size_t kTTCBlockSize = 6;
+const Register_t kRegTTCState(kAddrTTCBlock + 0);
+const Register_t kRegTTCClockFreq(kAddrTTCBlock + 1);
+const Register_t kRegTTCBC0Counter(kAddrTTCBlock + 2);
+const Register_t kRegTTCErrCountBC0(kAddrTTCBlock + 3);
+const Register_t kRegTTCErrCountSingleBit(kAddrTTCBlock + 4);
+const Register_t kRegTTCErrCountDoubleBit(kAddrTTCBlock + 5);
+
+// Event builder block
+const uint32_t kAddrEvbBlock = 0x0020;
+const size_t kEvbBlockSize = 4;
+const Register_t kRegEvbState(kAddrEvbBlock + 0);
+const Register_t kRegEvbOutOfSync(kAddrEvbBlock + 1, 0x1);
+const Register_t kRegEvbTTSWarning(kAddrEvbBlock + 1, 0x2);
+const Register_t kRegEvbL1ACountLow(kAddrEvbBlock + 2);
+const Register_t kRegEvbL1ACountHigh(kAddrEvbBlock + 3);
+
+// SLink express block
+const uint32_t kAddrSLinkBlock = 0x0030;
+const size_t kSLinkBlockSize = 4;
+const Register_t kRegSLinkState(kAddrSLinkBlock + 0);
+const Register_t kRegSLinkCoreInitialised(kAddrSLinkBlock + 1, 0x1);
+const Register_t kRegSLinkBackPressure(kAddrSLinkBlock + 1, 0x2);
+const Register_t kRegSLinkWordsSent(kAddrSLinkBlock + 2);
+const Register_t kRegSLinkPacketsSent(kAddrSLinkBlock + 3);
+
+// AMC backplane ports: block state, plus per-slot status words & event counters
+const Register_t kRegAMCPortState(0x0040);
+const uint32_t kAddrAMCPortStatus = 0x0100;
+const uint32_t kAddrAMCPortEventCountLow = 0x0200;
+const uint32_t kAddrAMCPortEventCountHigh = 0x0300;
+const size_t kMaxSlots = 0x20;
+const uint32_t kAMCPortOutOfSyncBit = 0x1;
+const uint32_t kAMCPortTTSWarningBit = 0x2;
+
+//! Address of the state register of each part of the status, indexed by DummyAMC13Driver::StatusBlockPart
+const uint32_t kPartStateAddresses[] = {kRegTTCState.address, kRegEvbState.address, kRegSLinkState.address, kRegAMCPortState.address};
+
+
+uint32_t getField(const uint32_t* aBlock, uint32_t aBlockAddress, const Register_t& aRegister)
+{
+  return DummyRegisterMap::getField(aBlock[aRegister.address - aBlockAddress], aRegister);
+}
+
+} // anonymous namespace
+
+
 DummyAMC13Driver::DummyAMC13Driver() :
-  mVec(2 * 2 * (1024 + 256) * 1024, 0x0),
-  mClkTtcState(kError),
-  mEvbState(kError),
-  mSLinkState(kError),
-  mAMCPortState(kError),
-  mRunning(false),
-  mFedId (0xFFFF)
+  mRegisters(2 * 2 * (1024 + 256) * 1024),
+  mTransaction(mRegisters),
+  mVerifyWrites(false),
+  mAppliedConfiguration(kNumConfigurationParts),
+  mNumCommits(0)
 {
+  static_assert((sizeof(kPartStateAddresses) / sizeof(kPartStateAddresses[0])) == kNumStatusBlockParts, "One state register per status block part");
+  for (size_t i = 0; i < kNumStatusBlockParts; i++) {
+    mStatusPollingSuspended[i] = false;
+    mNumStatusReads[i] = 0;
+    mNumFailedStatusReads[i] = 0;
+  }
+
+  mRegisters.addRegister("fedId", kRegFedId);
+  mRegisters.addRegister("running", kRegRunning);
+  mRegisters.addRegister("ttc.state", kRegTTCState);
+  mRegisters.addRegister("ttc.clockFreq", kRegTTCClockFreq);
+  mRegisters.addRegister("ttc.bc0Counter", kRegTTCBC0Counter);
+  mRegisters.addRegister("ttc.errCountBC0", kRegTTCErrCountBC0);
+  mRegisters.addRegister("ttc.errCountSingleBit", kRegTTCErrCountSingleBit);
+  mRegisters.addRegister("ttc.errCountDoubleBit", kRegTTCErrCountDoubleBit);
+  mRegisters.addRegister("evb.state", kRegEvbState);
+  mRegisters.addRegister("evb.outOfSync", kRegEvbOutOfSync);
+  mRegisters.addRegister("evb.ttsWarning", kRegEvbTTSWarning);
+  mRegisters.addRegister("evb.l1aCount.low", kRegEvbL1ACountLow);
+  mRegisters.addRegister("evb.l1aCount.high", kRegEvbL1ACountHigh);
+  mRegisters.addRegister("slink.state", kRegSLinkState);
+  mRegisters.addRegister("slink.coreInitialised", kRegSLinkCoreInitialised);
+  mRegisters.addRegister("slink.backPressure", kRegSLinkBackPressure);
+  mRegisters.addRegister("slink.wordsSent", kRegSLinkWordsSent);
+  mRegisters.addRegister("slink.packetsSent", kRegSLinkPacketsSent);
+  mRegisters.addRegister("amcPorts.state", kRegAMCPortState);
+  mRegisters.addRegister("amcPorts.status", Register_t(kAddrAMCPortStatus));
+  mRegisters.addRegister("amcPorts.eventCount.low", Register_t(kAddrAMCPortEventCountLow));
+  mRegisters.addRegister("amcPorts.eventCount.high", Register_t(kAddrAMCPortEventCountHigh));
+
+  mRegisters.write(kRegFedId, 0xFFFF);
+
   reboot();
 }
 
@@ -32,31 +119,60 @@ DummyAMC13Driver::~DummyAMC13Driver()
 
 DummyAMC13Driver::TTCStatus DummyAMC13Driver::readTTCStatus() const
 {
-  TTCStatus lStatus;
-  lStatus.bc0Counter = mRunning ? 42 : 0;
+  const boost::optional<TTCStatus> lStatus = tryReadTTCStatus();
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (TTC block).");
+  return *lStatus;
+}
 
-  switch (mClkTtcState) {
-    // Good & Warning : Almost all metric values are the same
-    case ComponentState::kGood :
-    case ComponentState::kWarning :
-      lStatus.clockFreq = 40.0e6;
-      lStatus.errCountBC0 = 0;
-      lStatus.errCountSingleBit = 0;
-      lStatus.errCountDoubleBit = 0;
-      lStatus.warningSign = (mClkTtcState == ComponentState::kWarning);
-      break;
-    // Error : Incorrect clock freq; error counters non-zero
-    case ComponentState::kError :
-      lStatus.clockFreq = 15.0e6;
-      lStatus.errCountBC0 = 5;
-      lStatus.errCountSingleBit = 100;
-      lStatus.errCountDoubleBit = 10;
-      lStatus.warningSign = true;
-      break;
-    // Hardware unreachable : Driver usually throws
-    case ComponentState::kNotReachable :
-      XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (TTC block).");
-  }
+
+DummyAMC13Driver::EventBuilderStatus DummyAMC13Driver::readEvbStatus() const
+{
+  const boost::optional<EventBuilderStatus> lStatus = tryReadEvbStatus();
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (event builder).");
+  return *lStatus;
+}
+
+
+DummyAMC13Driver::SLinkStatus DummyAMC13Driver::readSLinkStatus() const
+{
+  const boost::optional<SLinkStatus> lStatus = tryReadSLinkStatus();
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (SLink express).");
+  return *lStatus;
+}
+
+
+DummyAMC13Driver::AMCPortStatus DummyAMC13Driver::readAMCPortStatus(uint32_t aSlotId) const
+{
+  const boost::optional<AMCPortStatus> lStatus = tryReadAMCPortStatus(aSlotId);
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (AMC backplane port " + boost::lexical_cast<std::string>(aSlotId) + ").");
+  return *lStatus;
+}
+
+
+boost::optional<DummyAMC13Driver::TTCStatus> DummyAMC13Driver::tryReadTTCStatus() const
+{
+  if (mStatusPollingSuspended[kTTCPart])
+    return boost::none;
+
+  uint32_t lBlock[kTTCBlockSize];
+  mRegisters.readBlock(kAddrTTCBlock, kTTCBlockSize, lBlock);
+
+  const ComponentState lState = ComponentState(getField(lBlock, kAddrTTCBlock, kRegTTCState));
+
+  if (!recordStatusRead(kTTCPart, lState))
+    return boost::none;
+
+  TTCStatus lStatus;
+  lStatus.clockFreq = getField(lBlock, kAddrTTCBlock, kRegTTCClockFreq);
+  lStatus.bc0Counter = getField(lBlock, kAddrTTCBlock, kRegTTCBC0Counter);
+  lStatus.errCountBC0 = getField(lBlock, kAddrTTCBlock, kRegTTCErrCountBC0);
+  lStatus.errCountSingleBit = getField(lBlock, kAddrTTCBlock, kRegTTCErrCountSingleBit);
+  lStatus.errCountDoubleBit = getField(lBlock, kAddrTTCBlock, kRegTTCErrCountDoubleBit);
+  lStatus.warningSign = (lState != ComponentState::kGood);
 
   return lStatus;
 }
@@ -64,149 +180,389 @@ DummyAMC13Driver::TTCStatus DummyAMC13Driver::readTTCStatus() const
 
 uint16_t DummyAMC13Driver::readFedId() const
 {
-  return mFedId;
+  return mRegisters.read(kRegFedId);
 }
 
 
-DummyAMC13Driver::EventBuilderStatus DummyAMC13Driver::readEvbStatus() const
+boost::optional<DummyAMC13Driver::EventBuilderStatus> DummyAMC13Driver::tryReadEvbStatus() const
 {
-  EventBuilderStatus lStatus;
-  lStatus.outOfSync = (mEvbState == ComponentState::kError);
-  lStatus.ttsWarning = (mEvbState != ComponentState::kGood);
-  lStatus.l1aCount = mRunning ? 42 : 0;
+  if (mStatusPollingSuspended[kEvbPart])
+    return boost::none;
 
-  if (mEvbState == ComponentState::kNotReachable)
-    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (event builder).");
+  uint32_t lBlock[kEvbBlockSize];
+  mRegisters.readBlock(kAddrEvbBlock, kEvbBlockSize, lBlock);
+
+  if (!recordStatusRead(kEvbPart, ComponentState(getField(lBlock, kAddrEvbBlock, kRegEvbState))))
+    return boost::none;
+
+  EventBuilderStatus lStatus;
+  lStatus.outOfSync = getField(lBlock, kAddrEvbBlock, kRegEvbOutOfSync);
+  lStatus.ttsWarning = getField(lBlock, kAddrEvbBlock, kRegEvbTTSWarning);
+  lStatus.l1aCount = (uint64_t(getField(lBlock, kAddrEvbBlock, kRegEvbL1ACountHigh)) << 32) | getField(lBlock, kAddrEvbBlock, kRegEvbL1ACountLow);
 
   return lStatus;
 }
 
 
-DummyAMC13Driver::SLinkStatus DummyAMC13Driver::readSLinkStatus() const
+boost::optional<DummyAMC13Driver::SLinkStatus> DummyAMC13Driver::tryReadSLinkStatus() const
 {
-  SLinkStatus lStatus;
-  lStatus.coreInitialised = (mSLinkState != ComponentState::kError);
-  lStatus.backPressure = (mSLinkState != ComponentState::kGood);
-  lStatus.wordsSent = mRunning ? 42000 : 0;
-  lStatus.packetsSent = mRunning ? 42 : 0;
+  if (mStatusPollingSuspended[kSLinkPart])
+    return boost::none;
 
-  if (mSLinkState == ComponentState::kNotReachable)
-    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (event builder).");
+  uint32_t lBlock[kSLinkBlockSize];
+  mRegisters.readBlock(kAddrSLinkBlock, kSLinkBlockSize, lBlock);
+
+  if (!recordStatusRead(kSLinkPart, ComponentState(getField(lBlock, kAddrSLinkBlock, kRegSLinkState))))
+    return boost::none;
+
+  SLinkStatus lStatus;
+  lStatus.coreInitialised = getField(lBlock, kAddrSLinkBlock, kRegSLinkCoreInitialised);
+  lStatus.backPressure = getField(lBlock, kAddrSLinkBlock, kRegSLinkBackPressure);
+  lStatus.wordsSent = getField(lBlock, kAddrSLinkBlock, kRegSLinkWordsSent);
+  lStatus.packetsSent = getField(lBlock, kAddrSLinkBlock, kRegSLinkPacketsSent);
 
   return lStatus;
 }
 
 
-DummyAMC13Driver::AMCPortStatus DummyAMC13Driver::readAMCPortStatus(uint32_t aSlotId) const
+boost::optional<DummyAMC13Driver::AMCPortStatus> DummyAMC13Driver::tryReadAMCPortStatus(uint32_t aSlotId) const
 {
-  AMCPortStatus lStatus;
-  lStatus.outOfSync = (mAMCPortState == ComponentState::kError);
-  lStatus.ttsWarning = (mAMCPortState != ComponentState::kGood);
-  lStatus.amcEventCount = mRunning ? 42 : 0;
+  if (mStatusPollingSuspended[kAMCPortsPart] || !recordStatusRead(kAMCPortsPart, readState(kRegAMCPortState.address)))
+    return boost::none;
 
-  if (mAMCPortState == ComponentState::kNotReachable)
-    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with AMC13 (AMC backplane port " + boost::lexical_cast<std::string>(aSlotId) + ").");
+  const uint32_t lStatusWord = mRegisters.read(kAddrAMCPortStatus + aSlotId);
+
+  AMCPortStatus lStatus;
+  lStatus.outOfSync = (lStatusWord & kAMCPortOutOfSyncBit);
+  lStatus.ttsWarning = (lStatusWord & kAMCPortTTSWarningBit);
+  lStatus.amcEventCount = (uint64_t(mRegisters.read(kAddrAMCPortEventCountHigh + aSlotId)) << 32) | mRegisters.read(kAddrAMCPortEventCountLow + aSlotId);
 
   return lStatus;
 }
 
 
+bool DummyAMC13Driver::probe() const
+{
+  readFedId();
+
+  // The simulated AMC13 is only unreachable through the state of its blocks, so these are checked too
+  for (size_t i = 0; i < kNumStatusBlockParts; i++) {
+    if (readState(kPartStateAddresses[i]) == ComponentState::kNotReachable)
+      return false;
+  }
+  return true;
+}
+
+
+bool DummyAMC13Driver::probe(StatusBlockPart aPart) const
+{
+  readFedId();
+
+  // The simulated AMC13 is only unreachable through the state of its blocks, so the part's block is checked too
+  return (readState(kPartStateAddresses[aPart]) != ComponentState::kNotReachable);
+}
+
+
+void DummyAMC13Driver::setStatusPollingSuspended(StatusBlockPart aPart, bool aSuspended)
+{
+  mStatusPollingSuspended[aPart] = aSuspended;
+}
+
+
+uint64_t DummyAMC13Driver::getNumStatusReads(StatusBlockPart aPart) const
+{
+  return mNumStatusReads[aPart];
+}
+
+
+uint64_t DummyAMC13Driver::getNumFailedStatusReads(StatusBlockPart aPart) const
+{
+  return mNumFailedStatusReads[aPart];
+}
+
+
+uint64_t DummyAMC13Driver::getNumCommits() const
+{
+  return mNumCommits;
+}
+
+
+uint64_t DummyAMC13Driver::getAppliedConfiguration(ConfigurationPart aPart) const
+{
+  return mAppliedConfiguration.get(aPart, readState(aPart));
+}
+
+
+void DummyAMC13Driver::setAppliedConfiguration(ConfigurationPart aPart, uint64_t aHash)
+{
+  mAppliedConfiguration.set(aPart, aHash, readState(aPart));
+}
+
+
+void DummyAMC13Driver::setWriteVerification(bool aVerify)
+{
+  mVerifyWrites = aVerify;
+}
+
+
 void DummyAMC13Driver::reboot()
 {
-  mClkTtcState = kError;
-  mEvbState = kError;
-  mSLinkState = kError;
-  mAMCPortState = kError;
-  mRunning = false;
-  mFedId = 0;
+  mAppliedConfiguration.clearAll();
+  setClkTtcState(kError);
+  setEvbState(kError);
+  setSLinkState(kError);
+  setAMCPortState(kError);
+  setRunning(false);
+  mTransaction.write(kRegFedId, 0);
+  commit();
 }
 
 
 void DummyAMC13Driver::reset()
 {
-  mClkTtcState = kGood;
-  mEvbState = kError;
-  mSLinkState = kError;
-  mAMCPortState = kError;
-  mRunning = false;
-  mFedId = 0;
+  mAppliedConfiguration.clearAll();
+  setClkTtcState(kGood);
+  setEvbState(kError);
+  setSLinkState(kError);
+  setAMCPortState(kError);
+  setRunning(false);
+  mTransaction.write(kRegFedId, 0);
+  commit();
 }
 
 
 void DummyAMC13Driver::forceClkTtcState(ComponentState aNewState)
 {
-  mClkTtcState = aNewState;
+  setClkTtcState(aNewState);
+  commit();
 }
 
 
 void DummyAMC13Driver::configureEvb(uint16_t aFedId)
 {
-  if (mClkTtcState == kError)
+  if (readState(kRegTTCState.address) == kError)
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure event builder - no clock!");
   else {
-    mEvbState = kGood;
-    mFedId = aFedId;
+    setEvbState(kGood);
+    mTransaction.write(kRegFedId, aFedId);
+    commit();
   }
 }
 
 
 void DummyAMC13Driver::forceEvbState(ComponentState aNewState)
 {
-  mEvbState = aNewState;
+  setEvbState(aNewState);
+  commit();
 }
 
 
 void DummyAMC13Driver::configureSLink(uint16_t aFedId)
 {
-  if (mClkTtcState == kError)
+  if (readState(kRegTTCState.address) == kError)
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure event builder - no clock!");
   else {
-    mSLinkState = kGood;
-    mFedId = aFedId;
+    setSLinkState(kGood);
+    mTransaction.write(kRegFedId, aFedId);
+    commit();
   }
 }
 
 
 void DummyAMC13Driver::forceSLinkState(ComponentState aNewState)
 {
-  mSLinkState = aNewState;
+  setSLinkState(aNewState);
+  commit();
 }
 
 
 void DummyAMC13Driver::configureAMCPorts()
 {
-  if (mClkTtcState == kError)
+  if (readState(kRegTTCState.address) == kError)
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure AMC port - no clock!");
-  else
-    mAMCPortState = kGood;
+  else {
+    setAMCPortState(kGood);
+    commit();
+  }
 }
 
 
 void DummyAMC13Driver::forceAMCPortState(ComponentState aNewState)
 {
-  mAMCPortState = aNewState;
+  setAMCPortState(aNewState);
+  commit();
 }
 
 
 void DummyAMC13Driver::startDaq()
 {
-  if (mClkTtcState == kError)
+  if (readState(kRegTTCState.address) == kError)
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't start run - no clock!");
-  else if (mEvbState == kError)
+  else if (readState(kRegEvbState.address) == kError)
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't start run - my event builder isn't configured!");
-  else if (mSLinkState == kError)
+  else if (readState(kRegSLinkState.address) == kError)
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't start run - my SLink express block isn't configured!");
-  else
-    mRunning = true;
+  else {
+    setRunning(true);
+    commit();
+  }
 }
 
 
 void DummyAMC13Driver::stopDaq()
 {
-  if (!mRunning)
+  if (!mRegisters.read(kRegRunning))
     XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't stop run - not currently in run!");
-  else
-    mRunning = false;
+  else {
+    setRunning(false);
+    commit();
+  }
+}
+
+
+DummyRegisterMap& DummyAMC13Driver::getRegisterMap()
+{
+  return mRegisters;
+}
+
+
+void DummyAMC13Driver::setClkTtcState(ComponentState aNewState)
+{
+  mAppliedConfiguration.clear(kClockConfig);
+  mTransaction.write(kRegTTCState, aNewState);
+  switch (aNewState) {
+    // Good & Warning : Almost all metric values are the same
+    case ComponentState::kGood :
+    case ComponentState::kWarning :
+      mTransaction.write(kRegTTCClockFreq, 40000000);
+      mTransaction.write(kRegTTCErrCountBC0, 0);
+      mTransaction.write(kRegTTCErrCountSingleBit, 0);
+      mTransaction.write(kRegTTCErrCountDoubleBit, 0);
+      break;
+    // Error : Incorrect clock freq; error counters non-zero
+    case ComponentState::kError :
+      mTransaction.write(kRegTTCClockFreq, 15000000);
+      mTransaction.write(kRegTTCErrCountBC0, 5);
+      mTransaction.write(kRegTTCErrCountSingleBit, 100);
+      mTransaction.write(kRegTTCErrCountDoubleBit, 10);
+      break;
+    case ComponentState::kNotReachable :
+      break;
+  }
+}
+
+
+void DummyAMC13Driver::setEvbState(ComponentState aNewState)
+{
+  mAppliedConfiguration.clear(kEvbConfig);
+  mTransaction.write(kRegEvbState, aNewState);
+  mTransaction.write(kRegEvbOutOfSync, aNewState == ComponentState::kError);
+  mTransaction.write(kRegEvbTTSWarning, aNewState != ComponentState::kGood);
+}
+
+
+void DummyAMC13Driver::setSLinkState(ComponentState aNewState)
+{
+  mAppliedConfiguration.clear(kSLinkConfig);
+  mTransaction.write(kRegSLinkState, aNewState);
+  mTransaction.write(kRegSLinkCoreInitialised, aNewState != ComponentState::kError);
+  mTransaction.write(kRegSLinkBackPressure, aNewState != ComponentState::kGood);
+}
+
+
+void DummyAMC13Driver::setAMCPortState(ComponentState aNewState)
+{
+  mAppliedConfiguration.clear(kAMCPortsConfig);
+  uint32_t lStatusWord = 0x0;
+  if (aNewState == ComponentState::kError)
+    lStatusWord |= kAMCPortOutOfSyncBit;
+  if (aNewState != ComponentState::kGood)
+    lStatusWord |= kAMCPortTTSWarningBit;
+
+  mTransaction.write(kRegAMCPortState, aNewState);
+  mTransaction.fill(kAddrAMCPortStatus, kMaxSlots, lStatusWord);
+}
+
+
+void DummyAMC13Driver::setRunning(bool aRunning)
+{
+  mTransaction.write(kRegRunning, aRunning);
+  mTransaction.write(kRegTTCBC0Counter, aRunning ? 42 : 0);
+  mTransaction.write(kRegEvbL1ACountLow, aRunning ? 42 : 0);
+  mTransaction.write(kRegEvbL1ACountHigh, 0);
+  mTransaction.write(kRegSLinkWordsSent, aRunning ? 42000 : 0);
+  mTransaction.write(kRegSLinkPacketsSent, aRunning ? 42 : 0);
+  mTransaction.fill(kAddrAMCPortEventCountLow, kMaxSlots, aRunning ? 42 : 0);
+  mTransaction.fill(kAddrAMCPortEventCountHigh, kMaxSlots, 0);
+}
+
+
+void DummyAMC13Driver::commit()
+{
+  // Counted even if verification fails, since the words have been written by then
+  try {
+    mTransaction.commit(mVerifyWrites);
+  }
+  catch (...) {
+    mNumCommits++;
+    throw;
+  }
+  mNumCommits++;
+}
+
+
+ComponentState DummyAMC13Driver::readState(uint32_t aAddress) const
+{
+  return ComponentState(mRegisters.read(aAddress));
+}
+
+
+ComponentState DummyAMC13Driver::readState(ConfigurationPart aPart) const
+{
+  switch (aPart) {
+    case kClockConfig : return readState(kRegTTCState.address);
+    case kEvbConfig : return readState(kRegEvbState.address);
+    case kSLinkConfig : return readState(kRegSLinkState.address);
+    case kAMCPortsConfig : return readState(kRegAMCPortState.address);
+    case kNumConfigurationParts : break;
+  }
+  return ComponentState::kNotReachable;
+}
+
+
+bool DummyAMC13Driver::recordStatusRead(StatusBlockPart aPart, ComponentState aState) const
+{
+  mNumStatusReads[aPart]++;
+  if (aState != ComponentState::kNotReachable)
+    return true;
+  mNumFailedStatusReads[aPart]++;
+  return false;
+}
+
+
+bool DummyAMC13Driver::TTCStatus::operator==(const TTCStatus& aOther) const
+{
+  return (clockFreq == aOther.clockFreq) && (bc0Counter == aOther.bc0Counter) && (errCountBC0 == aOther.errCountBC0)
+      && (errCountSingleBit == aOther.errCountSingleBit) && (errCountDoubleBit == aOther.errCountDoubleBit) && (warningSign == aOther.warningSign);
+}
+
+
+bool DummyAMC13Driver::EventBuilderStatus::operator==(const EventBuilderStatus& aOther) const
+{
+  return (outOfSync == aOther.outOfSync) && (ttsWarning == aOther.ttsWarning) && (l1aCount == aOther.l1aCount);
+}
+
+
+bool DummyAMC13Driver::SLinkStatus::operator==(const SLinkStatus& aOther) const
+{
+  return (coreInitialised == aOther.coreInitialised) && (backPressure == aOther.backPressure)
+      && (wordsSent == aOther.wordsSent) && (packetsSent == aOther.packetsSent);
+}
+
+
+bool DummyAMC13Driver::AMCPortStatus::operator==(const AMCPortStatus& aOther) const
+{
+  return (outOfSync == aOther.outOfSync) && (ttsWarning == aOther.ttsWarning) && (amcEventCount == aOther.amcEventCount);
 }
 
 
@@ -11,9 +11,9 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
-AMC13BackplaneDaqPort::AMC13BackplaneDaqPort(uint32_t aSlot, DummyAMC13Driver& aDriver) :
+AMC13BackplaneDaqPort::AMC13BackplaneDaqPort(uint32_t aSlot, DummyAMC13StatusCache& aStatusCache) :
   swatch::dtm::AMCPort(aSlot),
-  mDriver(aDriver),
+  mStatusCache(aStatusCache),
   mOOS(registerMetric<bool>("outOfSync", swatch::core::EqualCondition<bool>(true))),
   mTTSWarning(registerMetric<bool>("ttsWarning")),
   mAMCEventCount(registerMetric<uint64_t>("amcEventCount") )
@@ -25,20 +25,36 @@ AMC13BackplaneDaqPort::~AMC13BackplaneDaqPort()
 {
 }
 
-void AMC13BackplaneDaqPort::retrieveMetricValues()
+bool AMC13BackplaneDaqPort::isDirty() const
 {
-  DummyAMC13Driver::AMCPortStatus lStatus = mDriver.readAMCPortStatus(getSlot());
+  return mChangeTracker.isDirty();
+}
 
-  setMetricValue<>(mOOS, lStatus.outOfSync);
-  setMetricValue<>(mTTSWarning, lStatus.ttsWarning);
-  setMetricValue<>(mAMCEventCount, lStatus.amcEventCount);
+DummyRefreshTimer& AMC13BackplaneDaqPort::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+void AMC13BackplaneDaqPort::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyAMC13Driver::AMCPortStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getAMCPortStatus(getSlot()) : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mOOS, lStatus->outOfSync);
+  setMetricValue<>(mTTSWarning, lStatus->ttsWarning);
+  setMetricValue<>(mAMCEventCount, lStatus->amcEventCount);
 }
 
 
 //--------------------------------------------------------------------
 
-AMC13EventBuilder::AMC13EventBuilder(DummyAMC13Driver& aDriver) :
-  mDriver(aDriver),
+AMC13EventBuilder::AMC13EventBuilder(DummyAMC13StatusCache& aStatusCache) :
+  mStatusCache(aStatusCache),
   mOOS(registerMetric<bool>("outOfSync", swatch::core::EqualCondition<bool>(true))),
   mTTSWarning(registerMetric<bool>("ttsWarning")),
   mL1ACount(registerMetric<uint64_t>("l1aCount"))
@@ -50,21 +66,37 @@ AMC13EventBuilder::~AMC13EventBuilder()
 {
 }
 
-void AMC13EventBuilder::retrieveMetricValues()
+bool AMC13EventBuilder::isDirty() const
 {
-  DummyAMC13Driver::EventBuilderStatus lStatus = mDriver.readEvbStatus();
+  return mChangeTracker.isDirty();
+}
 
-  setMetricValue<>(mOOS, lStatus.outOfSync);
-  setMetricValue<>(mTTSWarning, lStatus.ttsWarning);
-  setMetricValue<>(mL1ACount, lStatus.l1aCount);
+DummyRefreshTimer& AMC13EventBuilder::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+void AMC13EventBuilder::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyAMC13Driver::EventBuilderStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getEvbStatus() : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mOOS, lStatus->outOfSync);
+  setMetricValue<>(mTTSWarning, lStatus->ttsWarning);
+  setMetricValue<>(mL1ACount, lStatus->l1aCount);
 }
 
 
 //--------------------------------------------------------------------
 
-AMC13SLinkExpress::AMC13SLinkExpress(uint32_t aSfpId, DummyAMC13Driver& aDriver) :
+AMC13SLinkExpress::AMC13SLinkExpress(uint32_t aSfpId, DummyAMC13StatusCache& aStatusCache) :
   swatch::dtm::SLinkExpress(aSfpId),
-  mDriver(aDriver),
+  mStatusCache(aStatusCache),
   mCoreInitialised(registerMetric<bool>("coreInitialised", swatch::core::EqualCondition<bool>(false))),
   mBackPressure(registerMetric<bool>("backPressure")),
   mWordsSent(registerMetric<uint32_t>("wordsSent")),
@@ -77,21 +109,37 @@ AMC13SLinkExpress::~AMC13SLinkExpress()
 {
 }
 
-void AMC13SLinkExpress::retrieveMetricValues()
+bool AMC13SLinkExpress::isDirty() const
 {
-  DummyAMC13Driver::SLinkStatus lStatus = mDriver.readSLinkStatus();
+  return mChangeTracker.isDirty();
+}
 
-  setMetricValue<>(mCoreInitialised, lStatus.coreInitialised);
-  setMetricValue<>(mBackPressure, lStatus.backPressure);
-  setMetricValue<>(mWordsSent, lStatus.wordsSent);
-  setMetricValue<>(mPacketsSent, lStatus.packetsSent);
+DummyRefreshTimer& AMC13SLinkExpress::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+void AMC13SLinkExpress::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyAMC13Driver::SLinkStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getSLinkStatus() : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mCoreInitialised, lStatus->coreInitialised);
+  setMetricValue<>(mBackPressure, lStatus->backPressure);
+  setMetricValue<>(mWordsSent, lStatus->wordsSent);
+  setMetricValue<>(mPacketsSent, lStatus->packetsSent);
 }
 
 
 //--------------------------------------------------------------------
 
-AMC13TTC::AMC13TTC(DummyAMC13Driver& aDriver) :
-  mDriver(aDriver),
+AMC13TTC::AMC13TTC(DummyAMC13StatusCache& aStatusCache) :
+  mStatusCache(aStatusCache),
   mClockFreq(registerMetric<double>("clockFreq", swatch::core::InvRangeCondition<double>(39.9e6, 40.1e6))),
   mBC0Counter(registerMetric<uint32_t>("bc0Counter")),
   mErrCountBC0(registerMetric<uint32_t>("errCountBC0", swatch::core::GreaterThanCondition<uint32_t>(0))),
@@ -106,16 +154,32 @@ AMC13TTC::~AMC13TTC()
 {
 }
 
-void AMC13TTC::retrieveMetricValues()
+bool AMC13TTC::isDirty() const
 {
-  DummyAMC13Driver::TTCStatus lStatus = mDriver.readTTCStatus();
+  return mChangeTracker.isDirty();
+}
 
-  setMetricValue<>(mClockFreq, lStatus.clockFreq);
-  setMetricValue<>(mBC0Counter, lStatus.bc0Counter);
-  setMetricValue<>(mErrCountBC0, lStatus.errCountBC0);
-  setMetricValue<>(mErrCountSingleBit, lStatus.errCountSingleBit);
-  setMetricValue<>(mErrCountDoubleBit, lStatus.errCountDoubleBit);
-  setMetricValue<>(mWarningSign, lStatus.warningSign);
+DummyRefreshTimer& AMC13TTC::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+void AMC13TTC::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyAMC13Driver::TTCStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getTTCStatus() : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mClockFreq, lStatus->clockFreq);
+  setMetricValue<>(mBC0Counter, lStatus->bc0Counter);
+  setMetricValue<>(mErrCountBC0, lStatus->errCountBC0);
+  setMetricValue<>(mErrCountSingleBit, lStatus->errCountSingleBit);
+  setMetricValue<>(mErrCountDoubleBit, lStatus->errCountDoubleBit);
+  setMetricValue<>(mWarningSign, lStatus->warningSign);
 }
 
 
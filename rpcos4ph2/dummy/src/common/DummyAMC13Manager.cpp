@@ -3,17 +3,30 @@
 
 
 // boost headers
+#include "boost/chrono.hpp"
 #include "boost/foreach.hpp"
 
+// log4cplus headers
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
 // SWATCH headers
 #include "swatch/core/Factory.hpp"
+#include "swatch/core/MetricConditions.hpp"
 #include "swatch/action/StateMachine.hpp"
 #include "swatch/dtm/DaqTTCStub.hpp"
 #include "rpcos4ph2/dummy/DummyAMC13Driver.hpp"
+#include "rpcos4ph2/dummy/DummyAMC13StatusCache.hpp"
+#include "rpcos4ph2/dummy/DummyBoardBuilder.hpp"
 #include "rpcos4ph2/dummy/DummyAMC13Interfaces.hpp"
 #include "rpcos4ph2/dummy/DummyAMC13ManagerCommands.hpp"
 #include "swatch/dtm/AMCPortCollection.hpp"
 #include "swatch/action/CommandSequence.hpp"
+#include "rpcos4ph2/dummy/DummyRegisterMap.hpp"
+#include "rpcos4ph2/dummy/utilities.hpp"
+
+// C++ headers
+#include <algorithm>
 
 
 SWATCH_REGISTER_CLASS(rpcos4ph2::dummy::DummyAMC13Manager)
@@ -23,17 +36,59 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
+DummyAMC13Manager::Components::Components()
+{
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  driver.reset(new DummyAMC13Driver());
+  statusCache.reset(new DummyAMC13StatusCache(*driver, kNumAMCPorts));
+  ttc.reset(new AMC13TTC(*statusCache));
+  sLink.reset(new AMC13SLinkExpress(0, *statusCache));
+  amcPorts.reserve(kNumAMCPorts);
+  for ( uint32_t s(1); s<=kNumAMCPorts; ++s)
+    amcPorts.push_back(std::unique_ptr<AMC13BackplaneDaqPort>(new AMC13BackplaneDaqPort(s, *statusCache)));
+  evb.reset(new AMC13EventBuilder(*statusCache));
+
+  buildTime = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - lStartTime);
+}
+
+
+DummyAMC13Manager::Components::~Components()
+{
+}
+
+
 DummyAMC13Manager::DummyAMC13Manager( const swatch::core::AbstractStub& aStub ) :
   swatch::dtm::DaqTTCManager(aStub),
-  mDriver(new DummyAMC13Driver())
+  mMetricCircuitBreakerOpen(registerMetric<bool>("circuitBreakerOpen")),
+  mMetricConsecutiveFailures(registerMetric<uint32_t>("consecutiveFailures")),
+  mMetricCircuitBreakerTrips(registerMetric<uint32_t>("circuitBreakerTrips")),
+  mMetricPollingBackoff(registerMetric<float>("statusPollingBackoff"))
 {
-  // 0) Monitoring interfaces
-  registerInterface( new AMC13TTC(*mDriver) );
-  registerInterface( new AMC13SLinkExpress(0, *mDriver) );
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  // 0) Driver & monitoring interfaces: either built ahead by the system (possibly on another thread), or built now
+  std::unique_ptr<Components> lComponents(DummyBoardBuilder::takeAMC13Components(getStub()));
+  mDriver.reset(lComponents->driver.release());
+  mStatusCache.reset(lComponents->statusCache.release());
+
+  // Refresh timers, whose periods follow the schedule engaged by the cell (see engage)
+  mRefreshTimers.add(lComponents->ttc->getId(), lComponents->ttc->getRefreshTimer());
+  mRefreshTimers.add(lComponents->sLink->getId(), lComponents->sLink->getRefreshTimer());
+  for (auto it = lComponents->amcPorts.begin(); it != lComponents->amcPorts.end(); it++)
+    mRefreshTimers.add("amcPorts." + (*it)->getId(), (*it)->getRefreshTimer());
+  mRefreshTimers.add(lComponents->evb->getId(), lComponents->evb->getRefreshTimer());
+  mRefreshTimers.add("fedId", mFedIdTimer);
+
+  registerInterface( lComponents->ttc.release() );
+  registerInterface( lComponents->sLink.release() );
   registerInterface( new swatch::dtm::AMCPortCollection() );
-  for ( uint32_t s(1); s<=kNumAMCPorts; ++s)
-    getAMCPorts().addPort(new AMC13BackplaneDaqPort(s, *mDriver));
-  registerInterface( new AMC13EventBuilder(*mDriver));
+  for (auto it = lComponents->amcPorts.begin(); it != lComponents->amcPorts.end(); it++)
+    getAMCPorts().addPort(it->release());
+  registerInterface( lComponents->evb.release() );
+
+  // Throttled monitoring is flagged as a warning, so that it's distinguishable from a board in error
+  setWarningCondition<>(mMetricCircuitBreakerOpen, swatch::core::EqualCondition<bool>(true));
 
   // 1) Commands
   swatch::action::Command& reboot = registerCommand<DummyAMC13RebootCommand>("reboot");
@@ -63,6 +118,12 @@ DummyAMC13Manager::DummyAMC13Manager( const swatch::core::AbstractStub& aStub )
   //lFSM.resume;
   lFSM.stopFromPaused.add(stopDaq);
   lFSM.stopFromRunning.add(stopDaq);
+
+  // 4) Start-up report
+  const boost::chrono::milliseconds lDuration = boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now() - lStartTime);
+  LOG4CPLUS_INFO(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "DaqTTC manager '" << getId() << "' constructed in " << lDuration.count() << " ms "
+      << "(components built in " << (lComponents->buildTime.count() / 1000) << " ms); "
+      << (mDriver->getRegisterMap().getResidentBytes() / 1024) << " kB of register space resident; process RSS now " << (getProcessResidentBytes() / (1024 * 1024)) << " MB");
 }
 
 
@@ -71,11 +132,64 @@ DummyAMC13Manager::~DummyAMC13Manager()
 }
 
 
-void DummyAMC13Manager::retrieveMetricValues()
+void DummyAMC13Manager::expireRefreshTimers()
+{
+  mRefreshTimers.expire();
+}
+
+
+void DummyAMC13Manager::engage(const swatch::action::GateKeeper& aGateKeeper)
 {
-  DummyAMC13Driver::TTCStatus s = mDriver->readTTCStatus();
+  mRefreshTimers.engage(aGateKeeper, getGateKeeperContexts());
+  mDriver->setWriteVerification(readBoolParameter(aGateKeeper, getGateKeeperContexts(), "verifyWrites", false));
+}
 
-  setMetricValue<uint16_t>(mDaqMetricFedId, mDriver->readFedId());
+
+void DummyAMC13Manager::retrieveMetricValues()
+{
+  // Cached status is re-read in each cycle (unless the monitoring sweep has just prefetched it). Hardware reads below go
+  // through the cache too, so that they're bounded by the sweep's deadline
+  mStatusCache->startCycle();
+
+  // Refresh periods depend on the FSM state
+  mRefreshTimers.update(getStatus().getState());
+
+  // Circuit breakers: once a part of the AMC13 (e.g. the event builder) has failed in several consecutive cycles, its status
+  // (i.e. that of the interface or ports it covers) isn't polled until a probe with exponential backoff shows that it responds
+  // again; the other parts are still polled as usual.
+  // N.B. Relies on the board's metrics being updated before those of its interfaces & ports in each cycle
+  bool lAnyBreakerOpen = false;
+  size_t lMaxConsecutiveFailures = 0;
+  uint32_t lNumTrips = 0;
+  boost::chrono::milliseconds lMaxBackoff(0);
+  for (size_t i = 0; i < DummyAMC13Driver::kNumStatusBlockParts; i++) {
+    const DummyAMC13Driver::StatusBlockPart lPart = DummyAMC13Driver::StatusBlockPart(i);
+    DummyCircuitBreaker& lBreaker = mCircuitBreakers[i];
+    lBreaker.recordStatusReads(mDriver->getNumStatusReads(lPart), mDriver->getNumFailedStatusReads(lPart));
+    if (lBreaker.isProbeDue())
+      lBreaker.recordProbe(mStatusCache->probe(lPart));
+    const bool lBreakerOpen = (lBreaker.getState() != DummyCircuitBreaker::kClosed);
+    mDriver->setStatusPollingSuspended(lPart, lBreakerOpen);
+
+    lMaxConsecutiveFailures = std::max(lMaxConsecutiveFailures, lBreaker.getNumConsecutiveFailures());
+    lNumTrips += lBreaker.getNumTrips();
+    if (lBreakerOpen) {
+      lAnyBreakerOpen = true;
+      lMaxBackoff = std::max(lMaxBackoff, lBreaker.getBackoff());
+    }
+  }
+
+  setMetricValue<bool>(mMetricCircuitBreakerOpen, lAnyBreakerOpen);
+  setMetricValue<uint32_t>(mMetricConsecutiveFailures, uint32_t(lMaxConsecutiveFailures));
+  setMetricValue<uint32_t>(mMetricCircuitBreakerTrips, lNumTrips);
+  setMetricValue<float>(mMetricPollingBackoff, float(lMaxBackoff.count()) / 1000);
+
+  // FED ID is static, so typically re-read much less often than the other registers
+  if (mFedIdTimer.isDue() || !mFedId) {
+    mFedId.reset();
+    mFedId = mStatusCache->readFedId();
+  }
+  setMetricValue<uint16_t>(mDaqMetricFedId, *mFedId);
 }
 
 
@@ -2,9 +2,6 @@
 #include "rpcos4ph2/dummy/DummyAMC13ManagerCommands.hpp"
 
 
-// XDAQ headers
-#include "xdata/Vector.h"
-
 // SWATCH headers
 #include "swatch/dtm/AMCPortCollection.hpp"
 #include "swatch/dtm/AMCPort.hpp"
@@ -33,6 +30,7 @@ void DummyAMC13RebootCommand::runAction(bool aGoIntoError)
 {
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   lDriver.reboot();
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
 }
 
 
@@ -51,10 +49,18 @@ DummyAMC13ResetCommand::~DummyAMC13ResetCommand()
 void DummyAMC13ResetCommand::runAction(bool aGoIntoError)
 {
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.reset();
+    lDriver.setAppliedConfiguration(DummyAMC13Driver::kClockConfig, getConfigurationHash());
+  }
   else
     lDriver.forceClkTtcState(dummy::kError);
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
+}
+
+uint64_t DummyAMC13ResetCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyAMC13Manager>().getDriver().getAppliedConfiguration(DummyAMC13Driver::kClockConfig);
 }
 
 
@@ -74,10 +80,18 @@ void DummyAMC13ConfigureEvbCommand::runAction(bool aGoIntoError)
 {
   DummyAMC13Manager& lMgr = getActionable<DummyAMC13Manager>();
   DummyAMC13Driver& lDriver = lMgr.getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureEvb(lMgr.getStub().fedId);
+    lDriver.setAppliedConfiguration(DummyAMC13Driver::kEvbConfig, getConfigurationHash());
+  }
   else
     lDriver.forceEvbState(dummy::kError);
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
+}
+
+uint64_t DummyAMC13ConfigureEvbCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyAMC13Manager>().getDriver().getAppliedConfiguration(DummyAMC13Driver::kEvbConfig);
 }
 
 
@@ -97,10 +111,18 @@ void DummyAMC13ConfigureSLinkCommand::runAction(bool aGoIntoError)
 {
   DummyAMC13Manager& lMgr = getActionable<DummyAMC13Manager>();
   DummyAMC13Driver& lDriver = lMgr.getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureSLink(lMgr.getStub().fedId);
+    lDriver.setAppliedConfiguration(DummyAMC13Driver::kSLinkConfig, getConfigurationHash());
+  }
   else
     lDriver.forceSLinkState(dummy::kError);
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
+}
+
+uint64_t DummyAMC13ConfigureSLinkCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyAMC13Manager>().getDriver().getAppliedConfiguration(DummyAMC13Driver::kSLinkConfig);
 }
 
 
@@ -120,18 +142,33 @@ void DummyAMC13ConfigureAMCPortsCommand::runAction(bool aGoIntoError)
 {
   DummyAMC13Manager& lMgr = getActionable<DummyAMC13Manager>();
 
-  xdata::Vector<xdata::String> lPorts;
-  for (auto lIt=lMgr.getAMCPorts().getPorts().begin(); lIt != lMgr.getAMCPorts().getPorts().end(); lIt++) {
-    if (!(*lIt)->isMasked())
-      lPorts.push_back((*lIt)->getId());
-  }
-  addExecutionDetails("ports", lPorts);
+  const std::deque<swatch::dtm::AMCPort*>& lPorts = lMgr.getAMCPorts().getPorts();
+  mIncludedPorts.resize(lPorts.size());
+  for (size_t i = 0; i < lPorts.size(); i++)
+    mIncludedPorts.at(i) = !lPorts.at(i)->isMasked();
+  addExecutionDetails("ports", mPortIds.get(lPorts, mIncludedPorts));
 
   DummyAMC13Driver& lDriver = lMgr.getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureAMCPorts();
+    lDriver.setAppliedConfiguration(DummyAMC13Driver::kAMCPortsConfig, getConfigurationHash());
+  }
   else
     lDriver.forceAMCPortState(dummy::kError);
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
+}
+
+uint64_t DummyAMC13ConfigureAMCPortsCommand::hashInputs(uint64_t aHash)
+{
+  const std::deque<swatch::dtm::AMCPort*>& lPorts = getActionable<DummyAMC13Manager>().getAMCPorts().getPorts();
+  for (auto lIt = lPorts.begin(); lIt != lPorts.end(); lIt++)
+    aHash = addToHash(aHash, (*lIt)->isMasked());
+  return aHash;
+}
+
+uint64_t DummyAMC13ConfigureAMCPortsCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyAMC13Manager>().getDriver().getAppliedConfiguration(DummyAMC13Driver::kAMCPortsConfig);
 }
 
 
@@ -152,6 +189,7 @@ void DummyAMC13StartDaqCommand::runAction(bool aGoIntoError)
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   if (!aGoIntoError)
     lDriver.startDaq();
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
 }
 
 
@@ -172,6 +210,7 @@ void DummyAMC13StopDaqCommand::runAction(bool aGoIntoError)
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   if (!aGoIntoError)
     lDriver.stopDaq();
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
 }
 
 
@@ -192,6 +231,7 @@ swatch::action::Command::State DummyAMC13ForceClkTtcStateCommand::code(const swa
 {
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   lDriver.forceClkTtcState(parseState(aParamSet));
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
   return kDone;
 }
 
@@ -212,6 +252,7 @@ swatch::action::Command::State DummyAMC13ForceEvbStateCommand::code(const swatch
 {
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   lDriver.forceEvbState(parseState(aParamSet));
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
   return kDone;
 }
 
@@ -232,6 +273,7 @@ swatch::action::Command::State DummyAMC13ForceSLinkStateCommand::code(const swat
 {
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   lDriver.forceSLinkState(parseState(aParamSet));
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
   return kDone;
 }
 
@@ -252,6 +294,7 @@ swatch::action::Command::State DummyAMC13ForceAMCPortStateCommand::code(const sw
 {
   DummyAMC13Driver& lDriver = getActionable<DummyAMC13Manager>().getDriver();
   lDriver.forceAMCPortState(parseState(aParamSet));
+  getActionable<DummyAMC13Manager>().expireRefreshTimers();
   return kDone;
 }
 
@@ -0,0 +1,225 @@
+
+#include "rpcos4ph2/dummy/DummyAMC13StatusCache.hpp"
+
+
+#include <algorithm>
+
+#include "boost/bind.hpp"
+#include "boost/lexical_cast.hpp"
+#include "swatch/core/exception.hpp"
+
+#include "rpcos4ph2/dummy/DummyMonitoringSweep.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyAMC13StatusCache::DummyAMC13StatusCache(const DummyAMC13Driver& aDriver, uint32_t aNumAMCPorts) :
+  mDriver(aDriver),
+  mAMCPorts(aNumAMCPorts),
+  mPrefetched(false),
+  mSweep(NULL),
+  mBoard(0),
+  mUnavailable(false)
+{
+  std::fill(mValid, mValid + DummyAMC13Driver::kNumStatusBlockParts, false);
+  std::fill(mReadCommits, mReadCommits + DummyAMC13Driver::kNumStatusBlockParts, 0);
+  std::fill(mRequested, mRequested + DummyAMC13Driver::kNumStatusBlockParts, false);
+}
+
+
+DummyAMC13StatusCache::~DummyAMC13StatusCache()
+{
+}
+
+
+boost::optional<DummyAMC13Driver::TTCStatus> DummyAMC13StatusCache::getTTCStatus()
+{
+  if (!refresh(DummyAMC13Driver::kTTCPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  return mTTC;
+}
+
+
+boost::optional<DummyAMC13Driver::EventBuilderStatus> DummyAMC13StatusCache::getEvbStatus()
+{
+  if (!refresh(DummyAMC13Driver::kEvbPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  return mEvb;
+}
+
+
+boost::optional<DummyAMC13Driver::SLinkStatus> DummyAMC13StatusCache::getSLinkStatus()
+{
+  if (!refresh(DummyAMC13Driver::kSLinkPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  return mSLink;
+}
+
+
+boost::optional<DummyAMC13Driver::AMCPortStatus> DummyAMC13StatusCache::getAMCPortStatus(uint32_t aSlotId)
+{
+  if ((aSlotId == 0) || (aSlotId > mAMCPorts.size()))
+    XCEPT_RAISE(swatch::core::RuntimeError,"AMC backplane port " + boost::lexical_cast<std::string>(aSlotId) + " isn't cached (slots 1 to " + boost::lexical_cast<std::string>(mAMCPorts.size()) + ")");
+
+  if (!refresh(DummyAMC13Driver::kAMCPortsPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  return mAMCPorts.at(aSlotId - 1);
+}
+
+
+uint16_t DummyAMC13StatusCache::readFedId()
+{
+  return call<uint16_t>(boost::bind(&DummyAMC13Driver::readFedId, &mDriver), "FED ID");
+}
+
+
+bool DummyAMC13StatusCache::probe(DummyAMC13Driver::StatusBlockPart aPart)
+{
+  try {
+    return call<bool>([this, aPart] () { return mDriver.probe(aPart); }, "probe");
+  }
+  catch (const swatch::core::RuntimeError&) {
+    return false;
+  }
+}
+
+
+void DummyAMC13StatusCache::attach(DummyMonitoringSweep* aSweep, size_t aBoard)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  mSweep = aSweep;
+  mBoard = aBoard;
+}
+
+
+void DummyAMC13StatusCache::prefetch()
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  for (size_t i = 0; i < DummyAMC13Driver::kNumStatusBlockParts; i++) {
+    mValid[i] = false;
+    if (mRequested[i])
+      refreshIfStale(DummyAMC13Driver::StatusBlockPart(i));
+    mRequested[i] = false;
+  }
+  mPrefetched = true;
+}
+
+
+void DummyAMC13StatusCache::startCycle()
+{
+  if (mUnavailable)
+    return;
+
+  // The first board to start a cycle runs the sweep, which prefetches every board's status concurrently
+  DummyMonitoringSweep* lSweep = NULL;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    if (!mPrefetched)
+      lSweep = mSweep;
+  }
+  if (lSweep != NULL)
+    lSweep->run();
+
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  if (mPrefetched)
+    mPrefetched = false;
+  else
+    std::fill(mValid, mValid + DummyAMC13Driver::kNumStatusBlockParts, false);
+}
+
+
+void DummyAMC13StatusCache::setUnavailable(bool aUnavailable)
+{
+  mUnavailable = aUnavailable;
+}
+
+
+bool DummyAMC13StatusCache::refresh(DummyAMC13Driver::StatusBlockPart aPart)
+{
+  if (mUnavailable)
+    return false;
+
+  DummyMonitoringSweep* lSweep = NULL;
+  size_t lBoard = 0;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    mRequested[aPart] = true;
+    if (mValid[aPart] && (mReadCommits[aPart] == mDriver.getNumCommits()))
+      return true;
+    if (mSweep == NULL) {
+      refreshIfStale(aPart);
+      return true;
+    }
+    lSweep = mSweep;
+    lBoard = mBoard;
+  }
+
+  // N.B. mMutex mustn't be held here, since the sweep's worker locks it
+  return lSweep->run(lBoard, boost::bind(&DummyAMC13StatusCache::readPart, this, aPart));
+}
+
+
+void DummyAMC13StatusCache::readPart(DummyAMC13Driver::StatusBlockPart aPart)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  refreshIfStale(aPart);
+}
+
+
+template <typename T>
+T DummyAMC13StatusCache::call(const boost::function<T ()>& aFunction, const std::string& aDescription)
+{
+  DummyMonitoringSweep* lSweep = NULL;
+  size_t lBoard = 0;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    lSweep = mSweep;
+    lBoard = mBoard;
+  }
+  if (lSweep == NULL)
+    return aFunction();
+
+  const boost::optional<T> lResult = lSweep->call<T>(lBoard, aFunction);
+  if (!lResult)
+    XCEPT_RAISE(swatch::core::RuntimeError,"AMC13 didn't respond to " + aDescription + " read within the monitoring deadline");
+  return *lResult;
+}
+
+
+void DummyAMC13StatusCache::refreshIfStale(DummyAMC13Driver::StatusBlockPart aPart)
+{
+  // Commit count is read first, so that a change committed during the read triggers another one
+  const uint64_t lNumCommits = mDriver.getNumCommits();
+  if (mValid[aPart] && (mReadCommits[aPart] == lNumCommits))
+    return;
+
+  switch (aPart) {
+    case DummyAMC13Driver::kTTCPart :
+      mTTC = mDriver.tryReadTTCStatus();
+      break;
+    case DummyAMC13Driver::kEvbPart :
+      mEvb = mDriver.tryReadEvbStatus();
+      break;
+    case DummyAMC13Driver::kSLinkPart :
+      mSLink = mDriver.tryReadSLinkStatus();
+      break;
+    case DummyAMC13Driver::kAMCPortsPart :
+      for (size_t i = 0; i < mAMCPorts.size(); i++)
+        mAMCPorts.at(i) = mDriver.tryReadAMCPortStatus(i + 1);
+      break;
+    case DummyAMC13Driver::kNumStatusBlockParts :
+      break;
+  }
+  mReadCommits[aPart] = lNumCommits;
+  mValid[aPart] = true;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
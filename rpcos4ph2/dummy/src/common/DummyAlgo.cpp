@@ -1,21 +1,23 @@
 
 #include "rpcos4ph2/dummy/DummyAlgo.hpp"
-#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
 #include "swatch/core/MetricConditions.hpp"
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
+const size_t DummyAlgo::kNumRateCounters = 500;
 
-DummyAlgo::DummyAlgo(DummyProcDriver& aDriver) :
+
+DummyAlgo::DummyAlgo(DummyProcStatusCache& aStatusCache) :
   AlgoInterface(),
-  mDriver(aDriver),
+  mStatusCache(aStatusCache),
   mRateCounterA(registerMetric<float>("rateCounterA", swatch::core::GreaterThanCondition<float>(80e3), swatch::core::GreaterThanCondition<float>(40e3))),
-  mRateCounterB(registerMetric<float>("rateCounterB", swatch::core::GreaterThanCondition<float>(80e3), swatch::core::GreaterThanCondition<float>(40e3)))
+  mRateCounterB(registerMetric<float>("rateCounterB", swatch::core::GreaterThanCondition<float>(80e3), swatch::core::GreaterThanCondition<float>(40e3))),
+  mRateCounters("rate_counter_", kNumRateCounters)
 {
-  for (size_t i=0; i<500; i++)
-    registerMetric<float>("rate_counter_" + boost::lexical_cast<std::string>(i));
+  mRateCounters.registerMetrics([this] (const std::string& aId) -> swatch::core::SimpleMetric<float>& { return registerMetric<float>(aId); });
 }
 
 
@@ -24,12 +26,28 @@ DummyAlgo::~DummyAlgo()
 }
 
 
-void DummyAlgo::retrieveMetricValues()
+DummyRefreshTimer& DummyAlgo::getRefreshTimer()
 {
-  DummyProcDriver::AlgoStatus lStatus = mDriver.getAlgoStatus();
+  return mRefreshTimer;
+}
 
-  setMetricValue(mRateCounterA, lStatus.rateCounterA);
-  setMetricValue(mRateCounterB, lStatus.rateCounterB);
+
+void DummyAlgo::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  if (mRefreshTimer.isDue() || !mLastStatus) {
+    mLastStatus = mStatusCache.getAlgoStatus();
+    // Not reachable: leave the metrics unset, so that they're marked as unknown
+    if (!mLastStatus || !mStatusCache.getAlgoRateCounters(mRateCounters.getValues())) {
+      mLastStatus.reset();
+      return;
+    }
+  }
+
+  setMetricValue(mRateCounterA, mLastStatus->rateCounterA);
+  setMetricValue(mRateCounterB, mLastStatus->rateCounterB);
+
+  mRateCounters.pushValues([this] (swatch::core::SimpleMetric<float>& aMetric, const float& aValue) { setMetricValue(aMetric, aValue); });
 }
 
 } // namespace dummy
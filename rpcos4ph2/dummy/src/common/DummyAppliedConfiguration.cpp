@@ -0,0 +1,49 @@
+
+#include "rpcos4ph2/dummy/DummyAppliedConfiguration.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyAppliedConfiguration::DummyAppliedConfiguration(size_t aNumParts)
+{
+  const Entry lEmpty = { 0, kNotReachable };
+  mEntries.assign(aNumParts, lEmpty);
+}
+
+
+DummyAppliedConfiguration::~DummyAppliedConfiguration()
+{
+}
+
+
+uint64_t DummyAppliedConfiguration::get(size_t aPart, ComponentState aCurrentState) const
+{
+  const Entry& lEntry = mEntries.at(aPart);
+  return (lEntry.state == aCurrentState) ? lEntry.hash : 0;
+}
+
+
+void DummyAppliedConfiguration::set(size_t aPart, uint64_t aHash, ComponentState aState)
+{
+  mEntries.at(aPart).hash = aHash;
+  mEntries.at(aPart).state = aState;
+}
+
+
+void DummyAppliedConfiguration::clear(size_t aPart)
+{
+  mEntries.at(aPart).hash = 0;
+}
+
+
+void DummyAppliedConfiguration::clearAll()
+{
+  for (auto lIt = mEntries.begin(); lIt != mEntries.end(); lIt++)
+    lIt->hash = 0;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
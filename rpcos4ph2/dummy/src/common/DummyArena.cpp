@@ -0,0 +1,89 @@
+
+#include "rpcos4ph2/dummy/DummyArena.hpp"
+
+
+#include <stdint.h>
+#include <new>
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+const size_t DummyArena::kDefaultBlockSize = 64 * 1024;
+
+
+DummyArena::DummyArena(size_t aBlockSize) :
+  mBlockSize(aBlockSize),
+  mLargeBytes(0),
+  mCurrentBlock(0),
+  mOffset(0),
+  mBytesAllocated(0)
+{
+}
+
+
+DummyArena::~DummyArena()
+{
+  reset();
+  for (auto lIt = mBlocks.begin(); lIt != mBlocks.end(); lIt++)
+    ::operator delete(*lIt);
+}
+
+
+void* DummyArena::allocate(size_t aSize, size_t aAlignment)
+{
+  if (aSize > mBlockSize) {
+    mLargeBlocks.push_back(static_cast<char*>(::operator new(aSize)));
+    mLargeBytes += aSize;
+    mBytesAllocated += aSize;
+    return mLargeBlocks.back();
+  }
+
+  // Move on to the next block (allocating it if needed) when the current one is full
+  size_t lPadding = 0;
+  if (mCurrentBlock < mBlocks.size())
+    lPadding = (aAlignment - (uintptr_t(mBlocks.at(mCurrentBlock) + mOffset) & (aAlignment - 1))) & (aAlignment - 1);
+  if ((mCurrentBlock == mBlocks.size()) || (mOffset + lPadding + aSize > mBlockSize)) {
+    if (mCurrentBlock < mBlocks.size())
+      mCurrentBlock++;
+    if (mCurrentBlock == mBlocks.size())
+      mBlocks.push_back(static_cast<char*>(::operator new(mBlockSize)));
+    mOffset = 0;
+    lPadding = 0;
+  }
+
+  char* lResult = mBlocks.at(mCurrentBlock) + mOffset + lPadding;
+  mOffset += lPadding + aSize;
+  mBytesAllocated += lPadding + aSize;
+  return lResult;
+}
+
+
+void DummyArena::reset()
+{
+  for (auto lIt = mLargeBlocks.begin(); lIt != mLargeBlocks.end(); lIt++)
+    ::operator delete(*lIt);
+  mLargeBlocks.clear();
+  mLargeBytes = 0;
+
+  mCurrentBlock = 0;
+  mOffset = 0;
+  mBytesAllocated = 0;
+}
+
+
+size_t DummyArena::getBytesAllocated() const
+{
+  return mBytesAllocated;
+}
+
+
+size_t DummyArena::getBytesReserved() const
+{
+  return mBlocks.size() * mBlockSize + mLargeBytes;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -0,0 +1,192 @@
+
+#include "rpcos4ph2/dummy/DummyBoardBuilder.hpp"
+
+
+// C++ headers
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// boost headers
+#include "boost/chrono.hpp"
+#include "boost/thread/thread.hpp"
+
+// log4cplus headers
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+// SWATCH headers
+#include "swatch/system/SystemStub.hpp"
+#include "rpcos4ph2/dummy/DummyAMC13Driver.hpp"
+#include "rpcos4ph2/dummy/DummyAMC13Interfaces.hpp"
+#include "rpcos4ph2/dummy/DummyAlgo.hpp"
+#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
+#include "rpcos4ph2/dummy/DummyReadout.hpp"
+#include "rpcos4ph2/dummy/DummyRxPort.hpp"
+#include "rpcos4ph2/dummy/DummyTTC.hpp"
+#include "rpcos4ph2/dummy/DummyTxPort.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+boost::mutex DummyBoardBuilder::sMutex;
+std::map<std::string, std::unique_ptr<DummyProcessor::Components> > DummyBoardBuilder::sProcessorComponents;
+std::map<std::string, std::unique_ptr<DummyAMC13Manager::Components> > DummyBoardBuilder::sAMC13Components;
+
+
+namespace {
+
+const std::string kProcessorCreator = "rpcos4ph2::dummy::DummyProcessor";
+const std::string kAMC13Creator = "rpcos4ph2::dummy::DummyAMC13Manager";
+
+DummyProcessor::Components* newComponents(const swatch::processor::ProcessorStub& aStub)
+{
+  return new DummyProcessor::Components(aStub);
+}
+
+//! An AMC13's components are the same whatever its stub
+DummyAMC13Manager::Components* newComponents(const swatch::dtm::DaqTTCStub&)
+{
+  return new DummyAMC13Manager::Components();
+}
+
+//! Builds the components for each stub in turn, as claimed from the shared index; results are stored by stub index
+template <class StubType, class ComponentsType>
+void buildComponents(const std::vector<const StubType*>& aStubs, std::vector<std::unique_ptr<ComponentsType> >& aResults, std::atomic<size_t>& aNextIndex)
+{
+  for (size_t i = aNextIndex++; i < aStubs.size(); i = aNextIndex++) {
+    try {
+      aResults.at(i).reset(newComponents(*aStubs.at(i)));
+    }
+    catch (const std::exception& lException) {
+      // Leave this board's slot empty; it'll then be built (and the error reported) when the board is created
+      LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Could not build components of board '" << aStubs.at(i)->id << "' ahead of time: " << lException.what());
+    }
+  }
+}
+
+} // anonymous namespace
+
+
+DummyBoardBuilder::Scope::Scope(const swatch::core::AbstractStub& aStub, size_t aNrThreads)
+{
+  if (const swatch::system::SystemStub* lSystemStub = dynamic_cast<const swatch::system::SystemStub*>(&aStub)) {
+    if (aNrThreads > 1)
+      prebuild(*lSystemStub, aNrThreads);
+  }
+}
+
+
+DummyBoardBuilder::Scope::~Scope()
+{
+  clear();
+}
+
+
+void DummyBoardBuilder::prebuild(const swatch::system::SystemStub& aStub, size_t aNrThreads)
+{
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  std::vector<const swatch::processor::ProcessorStub*> lProcStubs;
+  for (auto lIt = aStub.processors.begin(); lIt != aStub.processors.end(); lIt++) {
+    if (lIt->creator == kProcessorCreator)
+      lProcStubs.push_back(&*lIt);
+  }
+  std::vector<const swatch::dtm::DaqTTCStub*> lAMC13Stubs;
+  for (auto lIt = aStub.daqttcs.begin(); lIt != aStub.daqttcs.end(); lIt++) {
+    if (lIt->creator == kAMC13Creator)
+      lAMC13Stubs.push_back(&*lIt);
+  }
+
+  // No more threads than boards
+  aNrThreads = std::min(aNrThreads, lProcStubs.size() + lAMC13Stubs.size());
+  if (aNrThreads < 2)
+    return;
+
+  std::vector<std::unique_ptr<DummyProcessor::Components> > lProcComponents(lProcStubs.size());
+  std::vector<std::unique_ptr<DummyAMC13Manager::Components> > lAMC13Components(lAMC13Stubs.size());
+  std::atomic<size_t> lNextProcIndex(0), lNextAMC13Index(0);
+
+  // Each worker builds processors first (the larger boards), then AMC13s
+  boost::thread_group lWorkers;
+  for (size_t i = 0; i < aNrThreads; i++) {
+    lWorkers.create_thread([&] () {
+      buildComponents(lProcStubs, lProcComponents, lNextProcIndex);
+      buildComponents(lAMC13Stubs, lAMC13Components, lNextAMC13Index);
+    });
+  }
+  lWorkers.join_all();
+
+  // Merge the results, and report per-board build times
+  log4cplus::Logger lLogger(log4cplus::Logger::getInstance("rpcos4ph2.dummy"));
+  boost::chrono::microseconds lTotalBuildTime(0);
+
+  boost::lock_guard<boost::mutex> lGuard(sMutex);
+  sProcessorComponents.clear();
+  sAMC13Components.clear();
+  for (size_t i = 0; i < lProcStubs.size(); i++) {
+    if (lProcComponents.at(i)) {
+      LOG4CPLUS_INFO(lLogger, "Built components of processor '" << lProcStubs.at(i)->id << "' in " << (lProcComponents.at(i)->buildTime.count() / 1000) << " ms");
+      lTotalBuildTime += lProcComponents.at(i)->buildTime;
+      sProcessorComponents[lProcStubs.at(i)->id] = std::move(lProcComponents.at(i));
+    }
+  }
+  for (size_t i = 0; i < lAMC13Stubs.size(); i++) {
+    if (lAMC13Components.at(i)) {
+      LOG4CPLUS_INFO(lLogger, "Built components of DaqTTC manager '" << lAMC13Stubs.at(i)->id << "' in " << (lAMC13Components.at(i)->buildTime.count() / 1000) << " ms");
+      lTotalBuildTime += lAMC13Components.at(i)->buildTime;
+      sAMC13Components[lAMC13Stubs.at(i)->id] = std::move(lAMC13Components.at(i));
+    }
+  }
+
+  const boost::chrono::milliseconds lDuration = boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now() - lStartTime);
+  LOG4CPLUS_INFO(lLogger, "Built components of " << sProcessorComponents.size() << " processors and " << sAMC13Components.size() << " DaqTTC managers on "
+      << aNrThreads << " threads in " << lDuration.count() << " ms (" << (lTotalBuildTime.count() / 1000) << " ms summed over boards)");
+}
+
+
+std::unique_ptr<DummyProcessor::Components> DummyBoardBuilder::takeProcessorComponents(const swatch::processor::ProcessorStub& aStub)
+{
+  {
+    boost::lock_guard<boost::mutex> lGuard(sMutex);
+    auto lIt = sProcessorComponents.find(aStub.id);
+    if (lIt != sProcessorComponents.end()) {
+      std::unique_ptr<DummyProcessor::Components> lComponents(std::move(lIt->second));
+      sProcessorComponents.erase(lIt);
+      return lComponents;
+    }
+  }
+
+  return std::unique_ptr<DummyProcessor::Components>(new DummyProcessor::Components(aStub));
+}
+
+
+std::unique_ptr<DummyAMC13Manager::Components> DummyBoardBuilder::takeAMC13Components(const swatch::dtm::DaqTTCStub& aStub)
+{
+  {
+    boost::lock_guard<boost::mutex> lGuard(sMutex);
+    auto lIt = sAMC13Components.find(aStub.id);
+    if (lIt != sAMC13Components.end()) {
+      std::unique_ptr<DummyAMC13Manager::Components> lComponents(std::move(lIt->second));
+      sAMC13Components.erase(lIt);
+      return lComponents;
+    }
+  }
+
+  return std::unique_ptr<DummyAMC13Manager::Components>(new DummyAMC13Manager::Components());
+}
+
+
+void DummyBoardBuilder::clear()
+{
+  boost::lock_guard<boost::mutex> lGuard(sMutex);
+  sProcessorComponents.clear();
+  sAMC13Components.clear();
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
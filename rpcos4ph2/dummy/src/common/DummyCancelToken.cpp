@@ -0,0 +1,96 @@
+
+#include "rpcos4ph2/dummy/DummyCancelToken.hpp"
+
+
+#include "swatch/action/Command.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+boost::mutex DummyCancelToken::sRegistryMutex;
+std::set<DummyCancelToken*> DummyCancelToken::sRegistry;
+
+
+DummyCancelToken::Scope::Scope(DummyCancelToken& aToken) :
+  mToken(aToken)
+{
+}
+
+
+DummyCancelToken::Scope::~Scope()
+{
+  mToken.reset();
+}
+
+
+DummyCancelToken::DummyCancelToken(const swatch::action::Command& aCommand, const std::string& aBoardId) :
+  mCommand(aCommand),
+  mBoardId(aBoardId),
+  mCancelled(false)
+{
+  boost::lock_guard<boost::mutex> lGuard(sRegistryMutex);
+  sRegistry.insert(this);
+}
+
+
+DummyCancelToken::~DummyCancelToken()
+{
+  boost::lock_guard<boost::mutex> lGuard(sRegistryMutex);
+  sRegistry.erase(this);
+}
+
+
+void DummyCancelToken::cancel()
+{
+  boost::function<void ()> lCallback;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    mCancelled = true;
+    lCallback = mCallback;
+  }
+  if (lCallback)
+    lCallback();
+}
+
+
+void DummyCancelToken::reset()
+{
+  mCancelled = false;
+}
+
+
+bool DummyCancelToken::isCancelled() const
+{
+  return mCancelled;
+}
+
+
+void DummyCancelToken::setCallback(const boost::function<void ()>& aCallback)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  mCallback = aCallback;
+}
+
+
+size_t DummyCancelToken::cancelActive(const std::string& aBoardId)
+{
+  boost::lock_guard<boost::mutex> lGuard(sRegistryMutex);
+  size_t lNumCancelled = 0;
+  for (auto lIt = sRegistry.begin(); lIt != sRegistry.end(); lIt++) {
+    if (!aBoardId.empty() && ((*lIt)->mBoardId != aBoardId))
+      continue;
+
+    const swatch::action::Functionoid::State lState = (*lIt)->mCommand.getStatus().getState();
+    if ((lState == swatch::action::Functionoid::kScheduled) || (lState == swatch::action::Functionoid::kRunning)) {
+      (*lIt)->cancel();
+      lNumCancelled++;
+    }
+  }
+  return lNumCancelled;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -0,0 +1,116 @@
+
+#include "rpcos4ph2/dummy/DummyCircuitBreaker.hpp"
+
+
+#include <algorithm>
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+const size_t DummyCircuitBreaker::kDefaultFailureThreshold = 3;
+const boost::chrono::milliseconds DummyCircuitBreaker::kDefaultInitialBackoff(5000);
+const boost::chrono::milliseconds DummyCircuitBreaker::kDefaultMaxBackoff(160000);
+
+
+DummyCircuitBreaker::DummyCircuitBreaker(size_t aFailureThreshold, const boost::chrono::milliseconds& aInitialBackoff, const boost::chrono::milliseconds& aMaxBackoff) :
+  mFailureThreshold(aFailureThreshold),
+  mInitialBackoff(aInitialBackoff),
+  mMaxBackoff(aMaxBackoff),
+  mState(kClosed),
+  mNumConsecutiveFailures(0),
+  mNumTrips(0),
+  mBackoff(aInitialBackoff),
+  mLastNumReads(0),
+  mLastNumFailedReads(0)
+{
+}
+
+
+DummyCircuitBreaker::~DummyCircuitBreaker()
+{
+}
+
+
+void DummyCircuitBreaker::recordStatusReads(uint64_t aNumReads, uint64_t aNumFailedReads)
+{
+  const bool lAnyReads = (aNumReads != mLastNumReads);
+  const bool lAnyFailures = (aNumFailedReads != mLastNumFailedReads);
+  mLastNumReads = aNumReads;
+  mLastNumFailedReads = aNumFailedReads;
+
+  // Cycles without any reads (e.g. all values republished) don't count either way
+  if (mState != kClosed)
+    return;
+  if (lAnyFailures) {
+    mNumConsecutiveFailures++;
+    if (mNumConsecutiveFailures >= mFailureThreshold) {
+      mNumTrips++;
+      mBackoff = mInitialBackoff;
+      open();
+    }
+  }
+  else if (lAnyReads)
+    mNumConsecutiveFailures = 0;
+}
+
+
+bool DummyCircuitBreaker::isProbeDue()
+{
+  if ((mState != kOpen) || (boost::chrono::steady_clock::now() < mNextProbeTime))
+    return false;
+
+  mState = kHalfOpen;
+  return true;
+}
+
+
+void DummyCircuitBreaker::recordProbe(bool aSuccess)
+{
+  if (aSuccess) {
+    mState = kClosed;
+    mNumConsecutiveFailures = 0;
+    mBackoff = mInitialBackoff;
+  }
+  else {
+    mNumConsecutiveFailures++;
+    mBackoff = std::min(mBackoff * 2, mMaxBackoff);
+    open();
+  }
+}
+
+
+DummyCircuitBreaker::State DummyCircuitBreaker::getState() const
+{
+  return mState;
+}
+
+
+size_t DummyCircuitBreaker::getNumConsecutiveFailures() const
+{
+  return mNumConsecutiveFailures;
+}
+
+
+uint32_t DummyCircuitBreaker::getNumTrips() const
+{
+  return mNumTrips;
+}
+
+
+const boost::chrono::milliseconds& DummyCircuitBreaker::getBackoff() const
+{
+  return mBackoff;
+}
+
+
+void DummyCircuitBreaker::open()
+{
+  mState = kOpen;
+  mNextProbeTime = boost::chrono::steady_clock::now() + mBackoff;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
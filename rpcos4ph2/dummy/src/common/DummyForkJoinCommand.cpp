@@ -0,0 +1,240 @@
+
+
+#include "rpcos4ph2/dummy/DummyForkJoinCommand.hpp"
+
+
+#include "boost/bind.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "xdata/String.h"
+#include "xdata/UnsignedInteger.h"
+
+#include "swatch/action/GateKeeper.hpp"
+#include "swatch/core/exception.hpp"
+
+#include "rpcos4ph2/dummy/DummyTransitionProfiler.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyForkJoinCommand::DummyForkJoinCommand(const std::string& aId, swatch::action::ActionableObject& aActionable) :
+  Command(aId, aActionable, xdata::String("Dummy command's default result!")),
+  mCancelToken(*this, aActionable.getId()),
+  mProfilerIndex(DummyTransitionProfiler::get().registerCommand(aActionable.getId(), aId))
+{
+}
+
+
+DummyForkJoinCommand::~DummyForkJoinCommand()
+{
+}
+
+
+DummyForkJoinCommand& DummyForkJoinCommand::addBranch(AbstractConfigureCommand& aCommand, const std::vector<std::string>& aDependencies)
+{
+  Branch lBranch;
+  lBranch.command = &aCommand;
+  for (auto lIt = aDependencies.begin(); lIt != aDependencies.end(); lIt++) {
+    size_t i = 0;
+    while ((i < mBranches.size()) && (mBranches.at(i).command->getId() != *lIt))
+      i++;
+    if (i == mBranches.size())
+      XCEPT_RAISE(swatch::core::RuntimeError, "Branch '" + aCommand.getId() + "' of command '" + getId() + "' depends on '" + *lIt + "', which isn't one of its earlier branches");
+    lBranch.dependencies.push_back(i);
+  }
+
+  swatch::core::XParameterSet* lParams = new swatch::core::XParameterSet();
+  lBranch.params.reset(lParams);
+  aCommand.resolveParameters(NULL, std::vector<std::string>(), *lParams);
+
+  lBranch.started = false;
+  lBranch.finished = false;
+  lBranch.state = kInitial;
+  lBranch.roundTrips = 0;
+
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  mBranches.push_back(lBranch);
+  return *this;
+}
+
+
+void DummyForkJoinCommand::engage(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  for (auto lIt = mBranches.begin(); lIt != mBranches.end(); lIt++) {
+    swatch::core::XParameterSet* lParams = new swatch::core::XParameterSet();
+    lIt->params.reset(lParams);
+    lIt->command->resolveParameters(&aGateKeeper, aContexts, *lParams);
+  }
+}
+
+
+DummyCancelToken& DummyForkJoinCommand::getCancelToken()
+{
+  return mCancelToken;
+}
+
+
+swatch::action::Command::State DummyForkJoinCommand::code(const swatch::core::XParameterSet& aParams)
+{
+  DummyTransitionProfiler::Scope lProfilerScope(mProfilerIndex);
+  lProfilerScope.markStarted();
+  DummyCancelToken::Scope lCancelScope(mCancelToken);
+
+  // Branches are scheduled here, so any cancellation left over from outside this execution is cleared
+  std::vector<size_t> lReady;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    for (auto lIt = mBranches.begin(); lIt != mBranches.end(); lIt++) {
+      lIt->executionParams = lIt->params;
+      lIt->started = false;
+      lIt->finished = false;
+      lIt->state = kInitial;
+      lIt->message.clear();
+      lIt->details.clear();
+      lIt->roundTrips = 0;
+      lIt->command->getCancelToken().reset();
+    }
+    lReady = takeReadyBranches();
+  }
+  setStatusMsg("Running " + boost::lexical_cast<std::string>(mBranches.size()) + " branches");
+  startBranches(lReady);
+
+  // Wait for the branches, passing on any cancellation (including one requested before this command started) at each wake-up
+  {
+    boost::unique_lock<boost::mutex> lLock(mMutex);
+    while (true) {
+      size_t lNumFinished = 0;
+      for (auto lIt = mBranches.begin(); lIt != mBranches.end(); lIt++)
+        lNumFinished += lIt->finished ? 1 : 0;
+      if (lNumFinished == mBranches.size())
+        break;
+      setProgress(float(lNumFinished) / float(mBranches.size()));
+
+      if (mCancelToken.isCancelled()) {
+        for (auto lIt = mBranches.begin(); lIt != mBranches.end(); lIt++) {
+          if (!lIt->finished)
+            lIt->command->getCancelToken().cancel();
+        }
+      }
+      mBranchFinished.wait_for(lLock, AbstractConfigureCommand::kStepDuration);
+    }
+  }
+
+  // The command's state is the worst of its branches', and its round-trips are theirs
+  State lState = kDone;
+  size_t lNumFailed = 0;
+  uint32_t lRoundTrips = 0;
+  for (auto lIt = mBranches.begin(); lIt != mBranches.end(); lIt++) {
+    lRoundTrips += lIt->roundTrips;
+    const std::string& lId = lIt->command->getId();
+    addExecutionDetails(lId, xdata::String(lIt->message));
+    for (auto lDetailIt = lIt->details.begin(); lDetailIt != lIt->details.end(); lDetailIt++)
+      addExecutionDetails(lId + "." + lDetailIt->first, xdata::String(lDetailIt->second));
+
+    if (lIt->state == kError) {
+      lState = kError;
+      lNumFailed++;
+    }
+    else if ((lIt->state == kWarning) && (lState == kDone))
+      lState = kWarning;
+  }
+
+  addExecutionDetails("roundTrips", xdata::UnsignedInteger(lRoundTrips));
+  lProfilerScope.addRoundTrips(lRoundTrips);
+  lProfilerScope.setState(lState);
+
+  if (lNumFailed > 0)
+    setStatusMsg(boost::lexical_cast<std::string>(lNumFailed) + " of " + boost::lexical_cast<std::string>(mBranches.size()) + " branches failed or weren't run");
+  else
+    setStatusMsg("All " + boost::lexical_cast<std::string>(mBranches.size()) + " branches completed");
+  return lState;
+}
+
+
+std::vector<size_t> DummyForkJoinCommand::takeReadyBranches()
+{
+  // Dependencies are earlier branches, so a branch that ends here is seen by its dependents later in the same pass
+  std::vector<size_t> lReady;
+  for (size_t i = 0; i < mBranches.size(); i++) {
+    Branch& lBranch = mBranches.at(i);
+    if (lBranch.started)
+      continue;
+
+    bool lWaiting = false;
+    std::string lReason;
+    for (auto lIt = lBranch.dependencies.begin(); lIt != lBranch.dependencies.end(); lIt++) {
+      const Branch& lDependency = mBranches.at(*lIt);
+      if (!lDependency.finished)
+        lWaiting = true;
+      else if ((lDependency.state == kError) && lReason.empty())
+        lReason = "not run, since '" + lDependency.command->getId() + "' failed";
+    }
+    if (lWaiting)
+      continue;
+    if (mCancelToken.isCancelled())
+      lReason = "not run, since cancelled";
+
+    lBranch.started = true;
+    if (!lReason.empty()) {
+      lBranch.finished = true;
+      lBranch.state = kError;
+      lBranch.message = lReason;
+      continue;
+    }
+    lBranch.startTime = boost::chrono::steady_clock::now();
+    lReady.push_back(i);
+  }
+  return lReady;
+}
+
+
+void DummyForkJoinCommand::startBranches(const std::vector<size_t>& aIndices)
+{
+  // Started branches' commands & parameters aren't changed until the execution ends, so they're read without the lock
+  for (auto lIt = aIndices.begin(); lIt != aIndices.end(); lIt++) {
+    const Branch& lBranch = mBranches.at(*lIt);
+    lBranch.command->start(*lBranch.executionParams, boost::bind(&DummyForkJoinCommand::finishBranch, this, *lIt, _1));
+  }
+}
+
+
+void DummyForkJoinCommand::finishBranch(size_t aIndex, const AbstractConfigureCommand::Outcome& aOutcome)
+{
+  std::string lMessage, lError;
+  State lState = aOutcome.state;
+  if (!aOutcome.error.empty()) {
+    lState = kError;
+    lMessage = "error";
+    lError = ": " + aOutcome.error;
+  }
+  else if (lState == kDone)
+    lMessage = "done";
+  else if (lState == kWarning)
+    lMessage = "warning";
+  else
+    lMessage = mCancelToken.isCancelled() ? "cancelled" : "error";
+
+  // The branches that were waiting for this one are marked as started before the lock is released, so that code() can't see
+  // every branch finished while they're still to be started
+  std::vector<size_t> lReady;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    Branch& lBranch = mBranches.at(aIndex);
+    const boost::chrono::milliseconds lRunningTime = boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now() - lBranch.startTime);
+    lBranch.finished = true;
+    lBranch.state = lState;
+    lBranch.message = lMessage + " after " + boost::lexical_cast<std::string>(lRunningTime.count()) + "ms" + lError;
+    lBranch.details = aOutcome.details;
+    lBranch.roundTrips = aOutcome.roundTrips;
+    lReady = takeReadyBranches();
+  }
+  mBranchFinished.notify_all();
+  startBranches(lReady);
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
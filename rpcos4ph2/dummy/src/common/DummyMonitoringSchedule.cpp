@@ -0,0 +1,118 @@
+
+#include "rpcos4ph2/dummy/DummyMonitoringSchedule.hpp"
+
+
+// boost headers
+#include "boost/lexical_cast.hpp"
+
+// log4cplus headers
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+// SWATCH headers
+#include "swatch/action/GateKeeper.hpp"
+
+// XDAQ headers
+#include "xdata/Table.h"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+const std::string DummyMonitoringSchedule::kParameterId = "refreshPeriods";
+
+
+DummyMonitoringSchedule::DummyMonitoringSchedule()
+{
+}
+
+
+DummyMonitoringSchedule::DummyMonitoringSchedule(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts)
+{
+  for (auto lContextIt = aContexts.begin(); lContextIt != aContexts.end(); lContextIt++) {
+    const swatch::action::GateKeeper::Parameter_t lParam = aGateKeeper.get("", "", kParameterId, std::vector<std::string>(1, *lContextIt));
+    if (!lParam)
+      continue;
+
+    const xdata::Table* lTable = dynamic_cast<const xdata::Table*>(lParam.get());
+    if (lTable == NULL) {
+      LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Parameter '" << kParameterId << "' in context '" << *lContextIt << "' isn't a table; ignored");
+      continue;
+    }
+
+    // N.B. xdata::Table's accessors aren't const
+    xdata::Table& lRows = const_cast<xdata::Table&>(*lTable);
+    PeriodMap_t lPeriods;
+    for (size_t i = 0; i < lRows.getRowCount(); i++) {
+      const std::string lPath = lRows.getValueAt(i, "path")->toString();
+      try {
+        const double lPeriod = boost::lexical_cast<double>(lRows.getValueAt(i, "period")->toString());
+        lPeriods[lRows.getValueAt(i, "state")->toString()][lPath] = boost::chrono::milliseconds(static_cast<int64_t>(lPeriod * 1000));
+      }
+      catch (const boost::bad_lexical_cast&) {
+        LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Invalid refresh period for '" << lPath << "' in context '" << *lContextIt << "'; ignored");
+      }
+    }
+    mPeriods.push_back(lPeriods);
+  }
+}
+
+
+DummyMonitoringSchedule::~DummyMonitoringSchedule()
+{
+}
+
+
+boost::chrono::milliseconds DummyMonitoringSchedule::getPeriod(const std::string& aState, const std::string& aPath) const
+{
+  boost::chrono::milliseconds lPeriod(0);
+  for (auto lIt = mPeriods.begin(); lIt != mPeriods.end(); lIt++) {
+    if (findPeriod(*lIt, aState, aPath, lPeriod))
+      break;
+  }
+  return lPeriod;
+}
+
+
+size_t DummyMonitoringSchedule::size() const
+{
+  size_t lSize = 0;
+  for (auto lContextIt = mPeriods.begin(); lContextIt != mPeriods.end(); lContextIt++) {
+    for (auto lStateIt = lContextIt->begin(); lStateIt != lContextIt->end(); lStateIt++)
+      lSize += lStateIt->second.size();
+  }
+  return lSize;
+}
+
+
+bool DummyMonitoringSchedule::findPeriod(const PeriodMap_t& aPeriods, const std::string& aState, const std::string& aPath, boost::chrono::milliseconds& aPeriod)
+{
+  // Entries for the specific state take precedence over those for all states (i.e. empty state ID)
+  const std::string lStates[] = {aState, ""};
+  for (size_t i = 0; i < (aState.empty() ? 1 : 2); i++) {
+    auto lStateIt = aPeriods.find(lStates[i]);
+    if (lStateIt == aPeriods.end())
+      continue;
+
+    // Try the full path first, then each parent in turn (e.g. "inputPorts.Rx00", then "inputPorts")
+    std::string lPath = aPath;
+    while (true) {
+      auto lIt = lStateIt->second.find(lPath);
+      if (lIt != lStateIt->second.end()) {
+        aPeriod = lIt->second;
+        return true;
+      }
+
+      const size_t lSeparator = lPath.rfind('.');
+      if (lSeparator == std::string::npos)
+        break;
+      lPath.resize(lSeparator);
+    }
+  }
+  return false;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
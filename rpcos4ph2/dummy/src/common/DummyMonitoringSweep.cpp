@@ -0,0 +1,232 @@
+
+
+#include "rpcos4ph2/dummy/DummyMonitoringSweep.hpp"
+
+
+// C++ headers
+#include <algorithm>
+
+// boost headers
+#include "boost/bind.hpp"
+
+// log4cplus headers
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyMonitoringSweep::Result::Result() :
+  wallTime(0),
+  numOverdue(0)
+{
+}
+
+
+DummyMonitoringSweep::State::State() :
+  maxThreads(1),
+  numBusy(0),
+  numIdle(0),
+  stopping(false)
+{
+}
+
+
+DummyMonitoringSweep::DummyMonitoringSweep(size_t aMaxThreads, boost::chrono::milliseconds aDeadline) :
+  mDeadline(aDeadline),
+  mState(new State())
+{
+  mState->maxThreads = std::max<size_t>(aMaxThreads, 1);
+}
+
+
+DummyMonitoringSweep::~DummyMonitoringSweep()
+{
+  boost::chrono::steady_clock::time_point lDeadline;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mState->mutex);
+    mState->stopping = true;
+    lDeadline = boost::chrono::steady_clock::now() + mDeadline;
+  }
+  mState->taskQueued.notify_all();
+
+  // Idle workers exit straight away; those still running a task are given until one more deadline, then left behind
+  size_t lNumDetached = 0;
+  for (auto lIt = mWorkers.begin(); lIt != mWorkers.end(); lIt++) {
+    if (!(*lIt)->try_join_until(lDeadline)) {
+      (*lIt)->detach();
+      lNumDetached++;
+    }
+  }
+  if (lNumDetached > 0)
+    LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Detached " << lNumDetached << " monitoring worker(s) whose tasks are still running");
+}
+
+
+void DummyMonitoringSweep::configure(size_t aMaxThreads, boost::chrono::milliseconds aDeadline)
+{
+  {
+    boost::lock_guard<boost::mutex> lGuard(mState->mutex);
+    mState->maxThreads = std::max<size_t>(aMaxThreads, 1);
+    mDeadline = aDeadline;
+  }
+  mState->taskQueued.notify_all();
+}
+
+
+size_t DummyMonitoringSweep::addBoard(const std::string& aId, const boost::function<void ()>& aPrefetch, const boost::function<void (bool)>& aSetOverdue)
+{
+  boost::lock_guard<boost::mutex> lGuard(mState->mutex);
+  Task lTask;
+  lTask.id = aId;
+  lTask.prefetch = aPrefetch;
+  lTask.setOverdue = aSetOverdue;
+  lTask.running = false;
+  lTask.finished = false;
+  lTask.latency = boost::chrono::microseconds(0);
+  mState->tasks.push_back(lTask);
+  return mState->tasks.size() - 1;
+}
+
+
+void DummyMonitoringSweep::run()
+{
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  State& lState = *mState;
+  boost::unique_lock<boost::mutex> lLock(lState.mutex);
+  const boost::chrono::steady_clock::time_point lDeadline = lStartTime + mDeadline;
+
+  // 1) Queue each board's prefetch, except for boards that are still busy with an earlier task
+  std::vector<bool> lDispatched(lState.tasks.size(), false);
+  size_t lNumPending = 0;
+  for (size_t i = 0; i < lState.tasks.size(); i++) {
+    if (lState.tasks.at(i).running)
+      continue;
+    dispatch(i, lState.tasks.at(i).prefetch, lStartTime);
+    lDispatched.at(i) = true;
+    lNumPending++;
+  }
+
+  // 2) Wait until all dispatched tasks have finished, or the deadline has passed
+  while (lNumPending > 0) {
+    if (lState.taskFinished.wait_until(lLock, lDeadline) == boost::cv_status::timeout)
+      break;
+
+    lNumPending = 0;
+    for (size_t i = 0; i < lState.tasks.size(); i++) {
+      if (lDispatched.at(i) && !lState.tasks.at(i).finished)
+        lNumPending++;
+    }
+  }
+
+  // 3) Collect results; tasks that are still running are flagged as overdue until they finish
+  Result lResult;
+  for (size_t i = 0; i < lState.tasks.size(); i++) {
+    Task& lTask = lState.tasks.at(i);
+    if (lDispatched.at(i) && lTask.finished)
+      lResult.latencies.push_back(lTask.latency);
+    else {
+      lResult.numOverdue++;
+      lTask.setOverdue(true);
+    }
+  }
+
+  lResult.wallTime = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - lStartTime);
+  mLastResult = lResult;
+}
+
+
+bool DummyMonitoringSweep::run(size_t aBoard, const boost::function<void ()>& aFunction)
+{
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  State& lState = *mState;
+  boost::unique_lock<boost::mutex> lLock(lState.mutex);
+  const boost::chrono::steady_clock::time_point lDeadline = lStartTime + mDeadline;
+
+  Task& lTask = lState.tasks.at(aBoard);
+  if (lTask.running)
+    return false;
+
+  dispatch(aBoard, aFunction, lStartTime);
+  while (!lTask.finished) {
+    if (lState.taskFinished.wait_until(lLock, lDeadline) == boost::cv_status::timeout) {
+      if (lTask.finished)
+        break;
+      lTask.setOverdue(true);
+      return false;
+    }
+  }
+  return true;
+}
+
+
+DummyMonitoringSweep::Result DummyMonitoringSweep::getLastResult() const
+{
+  boost::lock_guard<boost::mutex> lGuard(mState->mutex);
+  return mLastResult;
+}
+
+
+void DummyMonitoringSweep::dispatch(size_t aBoard, const boost::function<void ()>& aFunction, const boost::chrono::steady_clock::time_point& aStartTime)
+{
+  Task& lTask = mState->tasks.at(aBoard);
+  lTask.function = aFunction;
+  lTask.running = true;
+  lTask.finished = false;
+  lTask.startTime = aStartTime;
+  mState->queue.push_back(aBoard);
+
+  // Workers are only started when needed, up to the maximum number of tasks that run at once
+  if ((mState->numIdle < mState->queue.size()) && (mWorkers.size() < mState->maxThreads))
+    mWorkers.emplace_back(new boost::thread(boost::bind(&DummyMonitoringSweep::runWorker, mState)));
+  mState->taskQueued.notify_one();
+}
+
+
+void DummyMonitoringSweep::runWorker(const boost::shared_ptr<State>& aState)
+{
+  // Holds its own reference, so that the state outlives the sweep if this worker is detached
+  const boost::shared_ptr<State> lState(aState);
+  boost::unique_lock<boost::mutex> lLock(lState->mutex);
+  while (true) {
+    lState->numIdle++;
+    while ((lState->queue.empty() || (lState->numBusy >= lState->maxThreads)) && !lState->stopping)
+      lState->taskQueued.wait(lLock);
+    lState->numIdle--;
+    if (lState->stopping)
+      return;
+
+    const size_t lIndex = lState->queue.front();
+    lState->queue.pop_front();
+    const boost::function<void ()> lFunction = lState->tasks.at(lIndex).function;
+    lState->numBusy++;
+
+    lLock.unlock();
+    try {
+      lFunction();
+    }
+    catch (const std::exception& lException) {
+      LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Monitoring task for board '" << lState->tasks.at(lIndex).id << "' failed: " << lException.what());
+    }
+    lLock.lock();
+
+    lState->numBusy--;
+    Task& lTask = lState->tasks.at(lIndex);
+    lTask.latency = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - lTask.startTime);
+    lTask.running = false;
+    lTask.finished = true;
+    // Once the sweep has been destroyed, its boards may be gone too
+    if (!lState->stopping)
+      lTask.setOverdue(false);
+    lState->taskFinished.notify_all();
+    lState->taskQueued.notify_one();
+  }
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -0,0 +1,144 @@
+
+#include "rpcos4ph2/dummy/DummyPortAggregator.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyPortAggregator::Slot::Slot() :
+  isKnown(false),
+  isMasked(false),
+  isDisabled(false),
+  crcErrors(0),
+  isInError(false)
+{
+}
+
+
+DummyPortAggregator::DummyPortAggregator(size_t aNumSlots) :
+  mSlots(aNumSlots),
+  mTotalCRCErrors(0),
+  mNumInError(0),
+  mNumUnknown(aNumSlots)
+{
+}
+
+
+DummyPortAggregator::~DummyPortAggregator()
+{
+}
+
+
+size_t DummyPortAggregator::getNumSlots() const
+{
+  return mSlots.size();
+}
+
+
+void DummyPortAggregator::update(size_t aSlot, uint32_t aCRCErrors, bool aIsInError)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  Slot& lSlot = mSlots.at(aSlot);
+  remove(lSlot);
+  lSlot.isKnown = true;
+  lSlot.crcErrors = aCRCErrors;
+  lSlot.isInError = aIsInError;
+  add(lSlot);
+}
+
+
+void DummyPortAggregator::setUnknown(size_t aSlot)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  Slot& lSlot = mSlots.at(aSlot);
+  remove(lSlot);
+  lSlot.isKnown = false;
+  lSlot.crcErrors = 0;
+  lSlot.isInError = false;
+  add(lSlot);
+}
+
+
+void DummyPortAggregator::setMasked(size_t aSlot, bool aIsMasked)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  Slot& lSlot = mSlots.at(aSlot);
+  if (lSlot.isMasked == aIsMasked)
+    return;
+
+  remove(lSlot);
+  lSlot.isMasked = aIsMasked;
+  add(lSlot);
+}
+
+
+void DummyPortAggregator::setDisabled(size_t aSlot, bool aIsDisabled)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  Slot& lSlot = mSlots.at(aSlot);
+  if (lSlot.isDisabled == aIsDisabled)
+    return;
+
+  remove(lSlot);
+  lSlot.isDisabled = aIsDisabled;
+  add(lSlot);
+}
+
+
+bool DummyPortAggregator::getTotals(uint32_t& aCRCErrors, uint32_t& aNumInError) const
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  if (mNumUnknown > 0)
+    return false;
+
+  aCRCErrors = mTotalCRCErrors;
+  aNumInError = mNumInError;
+  return true;
+}
+
+
+const uint32_t* DummyPortAggregator::calculateTotalCRCErrors(const std::vector<swatch::core::MetricSnapshot>& /*aSnapshots*/) const
+{
+  uint32_t lCRCErrors, lNumInError;
+  return getTotals(lCRCErrors, lNumInError) ? new uint32_t(lCRCErrors) : NULL;
+}
+
+
+const uint32_t* DummyPortAggregator::calculateNumberInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& /*aSnapshots*/) const
+{
+  uint32_t lCRCErrors, lNumInError;
+  return getTotals(lCRCErrors, lNumInError) ? new uint32_t(lNumInError) : NULL;
+}
+
+
+void DummyPortAggregator::add(const Slot& aSlot)
+{
+  if (aSlot.isMasked || aSlot.isDisabled)
+    return;
+
+  if (!aSlot.isKnown)
+    mNumUnknown++;
+  else {
+    mTotalCRCErrors += aSlot.crcErrors;
+    mNumInError += (aSlot.isInError ? 1 : 0);
+  }
+}
+
+
+void DummyPortAggregator::remove(const Slot& aSlot)
+{
+  if (aSlot.isMasked || aSlot.isDisabled)
+    return;
+
+  if (!aSlot.isKnown)
+    mNumUnknown--;
+  else {
+    mTotalCRCErrors -= aSlot.crcErrors;
+    mNumInError -= (aSlot.isInError ? 1 : 0);
+  }
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
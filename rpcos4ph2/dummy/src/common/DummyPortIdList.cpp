@@ -0,0 +1,28 @@
+
+#include "rpcos4ph2/dummy/DummyPortIdList.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyPortIdList::DummyPortIdList() :
+  mValid(false),
+  mNumBuilds(0)
+{
+}
+
+
+DummyPortIdList::~DummyPortIdList()
+{
+}
+
+
+size_t DummyPortIdList::getNumBuilds() const
+{
+  return mNumBuilds;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
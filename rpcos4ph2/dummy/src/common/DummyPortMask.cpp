@@ -0,0 +1,64 @@
+
+#include "rpcos4ph2/dummy/DummyPortMask.hpp"
+
+
+#include "swatch/core/exception.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyPortMask::DummyPortMask(size_t aNumPorts) :
+  mNumPorts(aNumPorts),
+  mWords((aNumPorts + kBitsPerWord - 1) / kBitsPerWord)
+{
+  for (auto lIt = mWords.begin(); lIt != mWords.end(); lIt++)
+    lIt->store(0, std::memory_order_relaxed);
+}
+
+
+DummyPortMask::~DummyPortMask()
+{
+}
+
+
+size_t DummyPortMask::size() const
+{
+  return mNumPorts;
+}
+
+
+bool DummyPortMask::isMasked(size_t aIndex) const
+{
+  if (aIndex >= mNumPorts)
+    XCEPT_RAISE(swatch::core::RuntimeError, "Port index out of range for mask");
+  return (mWords[aIndex / kBitsPerWord].load(std::memory_order_relaxed) >> (aIndex % kBitsPerWord)) & 0x1;
+}
+
+
+bool DummyPortMask::setMasked(size_t aIndex, bool aIsMasked)
+{
+  if (isMasked(aIndex) == aIsMasked)
+    return false;
+
+  const uint64_t lBit = uint64_t(1) << (aIndex % kBitsPerWord);
+  if (aIsMasked)
+    mWords[aIndex / kBitsPerWord].fetch_or(lBit, std::memory_order_relaxed);
+  else
+    mWords[aIndex / kBitsPerWord].fetch_and(~lBit, std::memory_order_relaxed);
+  return true;
+}
+
+
+size_t DummyPortMask::count() const
+{
+  size_t lCount = 0;
+  for (auto lIt = mWords.begin(); lIt != mWords.end(); lIt++)
+    lCount += __builtin_popcountll(lIt->load(std::memory_order_relaxed));
+  return lCount;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
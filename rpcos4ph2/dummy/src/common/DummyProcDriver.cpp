@@ -1,6 +1,8 @@
 #include "rpcos4ph2/dummy/DummyProcDriver.hpp"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include "boost/lexical_cast.hpp"
 #include "swatch/core/TTSUtils.hpp"
@@ -11,9 +13,133 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
+namespace {
+
+typedef DummyRegisterMap::Register Register_t;
+
+// Firmware version
+const uint32_t kAddrFwVersion = 0x0000;
+
+// TTC block
+const uint32_t kAddrTTCBlock = 0x0010;
+const size_t kTTCBlockSize = 7;
+const Register_t kRegTTCState(kAddrTTCBlock + 0);
+const Register_t kRegTTCBunchCounter(kAddrTTCBlock + 1);
+const Register_t kRegTTCEventCounter(kAddrTTCBlock + 2);
+const Register_t kRegTTCOrbitCounter(kAddrTTCBlock + 3);
+const Register_t kRegTTCClk40Locked(kAddrTTCBlock + 4, 0x1);
+const Register_t kRegTTCClk40Stopped(kAddrTTCBlock + 4, 0x2);
+const Register_t kRegTTCBC0Locked(kAddrTTCBlock + 4, 0x4);
+const Register_t kRegTTCErrSingleBit(kAddrTTCBlock + 5);
+const Register_t kRegTTCErrDoubleBit(kAddrTTCBlock + 6);
+
+// Readout block
+const uint32_t kAddrReadoutBlock = 0x0020;
+const size_t kReadoutBlockSize = 3;
+const Register_t kRegReadoutState(kAddrReadoutBlock + 0);
+const Register_t kRegReadoutAMCCoreReady(kAddrReadoutBlock + 1, 0x1);
+const Register_t kRegReadoutTTSState(kAddrReadoutBlock + 1, 0xF0);
+const Register_t kRegReadoutEventCounter(kAddrReadoutBlock + 2);
+
+// Algo block (rate counters stored as IEEE 754 single-precision)
+const uint32_t kAddrAlgoBlock = 0x0030;
+const size_t kAlgoBlockSize = 3;
+const Register_t kRegAlgoState(kAddrAlgoBlock + 0);
+const Register_t kRegAlgoRateCounterA(kAddrAlgoBlock + 1);
+const Register_t kRegAlgoRateCounterBOffset(kAddrAlgoBlock + 2);
+const uint32_t kAddrAlgoRateCounters = 0x4000;
+
+// Rx & tx ports: block state, plus per-channel status words & CRC error counters
+const Register_t kRegRxState(0x0040);
+const Register_t kRegTxState(0x0050);
+const uint32_t kAddrRxChannelStatus = 0x1000;
+const uint32_t kAddrRxCrcErrors = 0x2000;
+const uint32_t kAddrTxChannelStatus = 0x3000;
+const uint32_t kRxLockedBit = 0x1;
+const uint32_t kRxAlignedBit = 0x2;
+const uint32_t kRxWarningBit = 0x4;
+const uint32_t kTxOperatingBit = 0x1;
+const uint32_t kTxWarningBit = 0x2;
+
+//! Address of the state register of each part of the status block, indexed by DummyProcDriver::StatusBlockPart
+const uint32_t kPartStateAddresses[] = {kRegTTCState.address, kRegReadoutState.address, kRegAlgoState.address, kRegRxState.address, kRegTxState.address};
+
+
+static_assert(sizeof(float) == sizeof(uint32_t), "Rate counters are stored as 32-bit floats");
+
+uint32_t encodeFloat(float aValue)
+{
+  uint32_t lWord;
+  std::memcpy(&lWord, &aValue, sizeof(lWord));
+  return lWord;
+}
+
+
+float decodeFloat(uint32_t aWord)
+{
+  float lValue;
+  std::memcpy(&lValue, &aWord, sizeof(lValue));
+  return lValue;
+}
+
+
+uint32_t getField(const uint32_t* aBlock, uint32_t aBlockAddress, const Register_t& aRegister)
+{
+  return DummyRegisterMap::getField(aBlock[aRegister.address - aBlockAddress], aRegister);
+}
+
+} // anonymous namespace
+
+
+const size_t DummyProcDriver::kMaxChannels = 0x1000;
+const size_t DummyProcDriver::kMaxAlgoRateCounters = 0x1000;
+
+
 DummyProcDriver::DummyProcDriver() :
-  mVec(2 * 2 * (1024 + 256) * 1024, 0x0)
+  mRegisters(2 * 2 * (1024 + 256) * 1024),
+  mTransaction(mRegisters),
+  mVerifyWrites(false),
+  mAppliedConfiguration(kNumConfigurationParts),
+  mNumCommits(0)
 {
+  static_assert((sizeof(kPartStateAddresses) / sizeof(kPartStateAddresses[0])) == kNumStatusBlockParts, "One state register per status block part");
+  for (size_t i = 0; i < kNumStatusBlockParts; i++) {
+    mStatusPollingSuspended[i] = false;
+    mNumStatusReads[i] = 0;
+    mNumFailedStatusReads[i] = 0;
+  }
+
+  mRegisters.addRegister("fwVersion.low", Register_t(kAddrFwVersion));
+  mRegisters.addRegister("fwVersion.high", Register_t(kAddrFwVersion + 1));
+  mRegisters.addRegister("ttc.state", kRegTTCState);
+  mRegisters.addRegister("ttc.bunchCounter", kRegTTCBunchCounter);
+  mRegisters.addRegister("ttc.eventCounter", kRegTTCEventCounter);
+  mRegisters.addRegister("ttc.orbitCounter", kRegTTCOrbitCounter);
+  mRegisters.addRegister("ttc.clk40Locked", kRegTTCClk40Locked);
+  mRegisters.addRegister("ttc.clk40Stopped", kRegTTCClk40Stopped);
+  mRegisters.addRegister("ttc.bc0Locked", kRegTTCBC0Locked);
+  mRegisters.addRegister("ttc.errSingleBit", kRegTTCErrSingleBit);
+  mRegisters.addRegister("ttc.errDoubleBit", kRegTTCErrDoubleBit);
+  mRegisters.addRegister("readout.state", kRegReadoutState);
+  mRegisters.addRegister("readout.amcCoreReady", kRegReadoutAMCCoreReady);
+  mRegisters.addRegister("readout.ttsState", kRegReadoutTTSState);
+  mRegisters.addRegister("readout.eventCounter", kRegReadoutEventCounter);
+  mRegisters.addRegister("algo.state", kRegAlgoState);
+  mRegisters.addRegister("algo.rateCounterA", kRegAlgoRateCounterA);
+  mRegisters.addRegister("algo.rateCounterBOffset", kRegAlgoRateCounterBOffset);
+  mRegisters.addRegister("algo.rateCounters", Register_t(kAddrAlgoRateCounters));
+  mRegisters.addRegister("rxPorts.state", kRegRxState);
+  mRegisters.addRegister("rxPorts.status", Register_t(kAddrRxChannelStatus));
+  mRegisters.addRegister("rxPorts.crcErrors", Register_t(kAddrRxCrcErrors));
+  mRegisters.addRegister("txPorts.state", kRegTxState);
+  mRegisters.addRegister("txPorts.status", Register_t(kAddrTxChannelStatus));
+
+  const uint32_t lFwVersion[2] = {0x00001234, 0xdeadbeef};
+  mRegisters.writeBlock(kAddrFwVersion, 2, lFwVersion);
+  mRegisters.write(kRegTTCBunchCounter, 0x00001234);
+  mRegisters.write(kRegTTCEventCounter, 0xdeadbeef);
+  mRegisters.write(kRegTTCOrbitCounter, 0x0000cafe);
+
   reboot();
 }
 
@@ -25,194 +151,650 @@ DummyProcDriver::~DummyProcDriver()
 
 uint64_t DummyProcDriver::getFirmwareVersion() const
 {
-  return 0xdeadbeef00001234;
+  uint32_t lWords[2];
+  mRegisters.readBlock(kAddrFwVersion, 2, lWords);
+  return (uint64_t(lWords[1]) << 32) | lWords[0];
 }
 
 
 DummyProcDriver::TTCStatus DummyProcDriver::getTTCStatus() const
 {
-  TTCStatus lStatus;
-  lStatus.bunchCounter = 0x00001234;
-  lStatus.eventCounter = 0xdeadbeef;
-  lStatus.orbitCounter = 0x0000cafe;
+  const boost::optional<TTCStatus> lStatus = tryGetTTCStatus();
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (TTC block).");
+  return *lStatus;
+}
 
-  lStatus.clk40Stopped = (mClkState == ComponentState::kError);
-  lStatus.clk40Locked = (mClkState != ComponentState::kError);
-  lStatus.bc0Locked = (mClkState != ComponentState::kError);
-  lStatus.errSingleBit = (mClkState == ComponentState::kError) ? 42 : 0;
-  lStatus.errDoubleBit = (mClkState == ComponentState::kError) ? 4 : 0;
 
-  lStatus.warningSign = (mClkState != ComponentState::kGood);
+DummyProcDriver::ReadoutStatus DummyProcDriver::getReadoutStatus() const
+{
+  const boost::optional<ReadoutStatus> lStatus = tryGetReadoutStatus();
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (readout block).");
+  return *lStatus;
+}
 
-  // Hardware unreachable : Driver usually throws
-  if (mClkState == ComponentState::kNotReachable)
-    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (TTC block).");
 
-  return lStatus;
+DummyProcDriver::RxPortStatus DummyProcDriver::getRxPortStatus(uint32_t aChannelId) const
+{
+  const boost::optional<RxPortStatus> lStatus = tryGetRxPortStatus(aChannelId);
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (rx port " + boost::lexical_cast<std::string>(aChannelId) + ").");
+  return *lStatus;
 }
 
 
-DummyProcDriver::ReadoutStatus DummyProcDriver::getReadoutStatus() const
+DummyProcDriver::TxPortStatus DummyProcDriver::getTxPortStatus(uint32_t aChannelId) const
 {
-  namespace tts=swatch::core::tts;
-  switch (mReadoutState) {
+  const boost::optional<TxPortStatus> lStatus = tryGetTxPortStatus(aChannelId);
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (tx port " + boost::lexical_cast<std::string>(aChannelId) + ").");
+  return *lStatus;
+}
+
+
+DummyProcDriver::AlgoStatus DummyProcDriver::getAlgoStatus() const
+{
+  const boost::optional<AlgoStatus> lStatus = tryGetAlgoStatus();
+  if (!lStatus)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (algo block).");
+  return *lStatus;
+}
+
+
+boost::optional<DummyProcDriver::TTCStatus> DummyProcDriver::tryGetTTCStatus() const
+{
+  if (mStatusPollingSuspended[kTTCPart])
+    return boost::none;
+
+  uint32_t lBlock[kTTCBlockSize];
+  mRegisters.readBlock(kAddrTTCBlock, kTTCBlockSize, lBlock);
+
+  if (!recordStatusRead(kTTCPart, ComponentState(lBlock[0])))
+    return boost::none;
+
+  return decodeTTCStatus(lBlock);
+}
+
+
+boost::optional<DummyProcDriver::ReadoutStatus> DummyProcDriver::tryGetReadoutStatus() const
+{
+  if (mStatusPollingSuspended[kReadoutPart])
+    return boost::none;
+
+  uint32_t lBlock[kReadoutBlockSize];
+  mRegisters.readBlock(kAddrReadoutBlock, kReadoutBlockSize, lBlock);
+
+  if (!recordStatusRead(kReadoutPart, ComponentState(lBlock[0])))
+    return boost::none;
+
+  return decodeReadoutStatus(lBlock);
+}
+
+
+boost::optional<DummyProcDriver::RxPortStatus> DummyProcDriver::tryGetRxPortStatus(uint32_t aChannelId) const
+{
+  if (aChannelId >= kMaxChannels)
+    XCEPT_RAISE(swatch::core::RuntimeError, "Invalid rx channel ID " + boost::lexical_cast<std::string>(aChannelId) + " (maximum " + boost::lexical_cast<std::string>(kMaxChannels - 1) + ")");
+  if (mStatusPollingSuspended[kRxPart] || !recordStatusRead(kRxPart, readState(kRegRxState.address)))
+    return boost::none;
+
+  const uint32_t lStatusWord = mRegisters.read(kAddrRxChannelStatus + aChannelId);
+  const uint32_t lCrcErrCount = mRegisters.read(kAddrRxCrcErrors + aChannelId);
+  return RxPortStatus(lStatusWord & kRxLockedBit, lStatusWord & kRxAlignedBit, lCrcErrCount, lStatusWord & kRxWarningBit);
+}
+
+
+boost::optional<DummyProcDriver::TxPortStatus> DummyProcDriver::tryGetTxPortStatus(uint32_t aChannelId) const
+{
+  if (aChannelId >= kMaxChannels)
+    XCEPT_RAISE(swatch::core::RuntimeError, "Invalid tx channel ID " + boost::lexical_cast<std::string>(aChannelId) + " (maximum " + boost::lexical_cast<std::string>(kMaxChannels - 1) + ")");
+  if (mStatusPollingSuspended[kTxPart] || !recordStatusRead(kTxPart, readState(kRegTxState.address)))
+    return boost::none;
+
+  const uint32_t lStatusWord = mRegisters.read(kAddrTxChannelStatus + aChannelId);
+  return TxPortStatus(lStatusWord & kTxOperatingBit, lStatusWord & kTxWarningBit);
+}
+
+
+boost::optional<DummyProcDriver::AlgoStatus> DummyProcDriver::tryGetAlgoStatus() const
+{
+  if (mStatusPollingSuspended[kAlgoPart])
+    return boost::none;
+
+  uint32_t lBlock[kAlgoBlockSize];
+  mRegisters.readBlock(kAddrAlgoBlock, kAlgoBlockSize, lBlock);
+
+  if (!recordStatusRead(kAlgoPart, ComponentState(lBlock[0])))
+    return boost::none;
+
+  return decodeAlgoStatus(lBlock);
+}
+
+
+void DummyProcDriver::readAllStatus(StatusBlock& aBlock) const
+{
+  for (size_t i = 0; i < kNumStatusBlockParts; i++)
+    readStatus(aBlock, StatusBlockPart(i));
+}
+
+
+void DummyProcDriver::readStatus(StatusBlock& aBlock, StatusBlockPart aPart) const
+{
+  // Blocks that aren't reachable are flagged, rather than throwing, so that the rest of the board is still read out
+  if (mStatusPollingSuspended[aPart]) {
+    switch (aPart) {
+      case kTTCPart : aBlock.ttcReachable = false; break;
+      case kReadoutPart : aBlock.readoutReachable = false; break;
+      case kAlgoPart : aBlock.algoReachable = false; break;
+      case kRxPart : aBlock.rxReachable = false; break;
+      case kTxPart : aBlock.txReachable = false; break;
+      case kNumStatusBlockParts : break;
+    }
+    return;
+  }
+
+  switch (aPart) {
+    case kTTCPart : {
+      uint32_t lTTCBlock[kTTCBlockSize];
+      mRegisters.readBlock(kAddrTTCBlock, kTTCBlockSize, lTTCBlock);
+      aBlock.ttcReachable = recordStatusRead(kTTCPart, ComponentState(lTTCBlock[0]));
+      if (aBlock.ttcReachable)
+        aBlock.ttc = decodeTTCStatus(lTTCBlock);
+      break;
+    }
+    case kReadoutPart : {
+      uint32_t lReadoutBlock[kReadoutBlockSize];
+      mRegisters.readBlock(kAddrReadoutBlock, kReadoutBlockSize, lReadoutBlock);
+      aBlock.readoutReachable = recordStatusRead(kReadoutPart, ComponentState(lReadoutBlock[0]));
+      if (aBlock.readoutReachable)
+        aBlock.readout = decodeReadoutStatus(lReadoutBlock);
+      break;
+    }
+    case kAlgoPart : {
+      uint32_t lAlgoBlock[kAlgoBlockSize];
+      mRegisters.readBlock(kAddrAlgoBlock, kAlgoBlockSize, lAlgoBlock);
+      aBlock.algoReachable = recordStatusRead(kAlgoPart, ComponentState(lAlgoBlock[0]));
+      if (aBlock.algoReachable) {
+        aBlock.algo = decodeAlgoStatus(lAlgoBlock);
+        // Rate counters are already in float format, so are copied straight into the array
+        if (!aBlock.algoRateCounters.empty()) {
+          const size_t lNumCounters = std::min(aBlock.algoRateCounters.size(), kMaxAlgoRateCounters);
+          mRegisters.readBlock(kAddrAlgoRateCounters, lNumCounters, reinterpret_cast<uint32_t*>(&aBlock.algoRateCounters[0]));
+        }
+      }
+      break;
+    }
+    // Per-channel registers: one block read per array
+    case kRxPart :
+      aBlock.rxReachable = recordStatusRead(kRxPart, readState(kRegRxState.address));
+      if (aBlock.rxReachable && !aBlock.rxIsLocked.empty()) {
+        const size_t lNumRx = std::min(aBlock.rxIsLocked.size(), kMaxChannels);
+        uint32_t* lChannelWords = &aBlock.channelWords[0];
+        mRegisters.readBlock(kAddrRxChannelStatus, lNumRx, lChannelWords);
+        mRegisters.readBlock(kAddrRxCrcErrors, lNumRx, &aBlock.rxCrcErrCount[0]);
+        for (size_t i = 0; i < lNumRx; i++) {
+          aBlock.rxIsLocked[i] = ((lChannelWords[i] & kRxLockedBit) != 0);
+          aBlock.rxIsAligned[i] = ((lChannelWords[i] & kRxAlignedBit) != 0);
+          aBlock.rxWarningSign[i] = ((lChannelWords[i] & kRxWarningBit) != 0);
+        }
+      }
+      break;
+    case kTxPart :
+      aBlock.txReachable = recordStatusRead(kTxPart, readState(kRegTxState.address));
+      if (aBlock.txReachable && !aBlock.txIsOperating.empty()) {
+        const size_t lNumTx = std::min(aBlock.txIsOperating.size(), kMaxChannels);
+        uint32_t* lChannelWords = &aBlock.channelWords[0];
+        mRegisters.readBlock(kAddrTxChannelStatus, lNumTx, lChannelWords);
+        for (size_t i = 0; i < lNumTx; i++) {
+          aBlock.txIsOperating[i] = ((lChannelWords[i] & kTxOperatingBit) != 0);
+          aBlock.txWarningSign[i] = ((lChannelWords[i] & kTxWarningBit) != 0);
+        }
+      }
+      break;
+    case kNumStatusBlockParts :
+      break;
+  }
+}
+
+
+bool DummyProcDriver::probe() const
+{
+  getFirmwareVersion();
+
+  // The simulated board is only unreachable through the state of its blocks, so these are checked too
+  for (size_t i = 0; i < kNumStatusBlockParts; i++) {
+    if (readState(kPartStateAddresses[i]) == ComponentState::kNotReachable)
+      return false;
+  }
+  return true;
+}
+
+
+bool DummyProcDriver::probe(StatusBlockPart aPart) const
+{
+  getFirmwareVersion();
+
+  // The simulated board is only unreachable through the state of its blocks, so the part's block is checked too
+  return (readState(kPartStateAddresses[aPart]) != ComponentState::kNotReachable);
+}
+
+
+void DummyProcDriver::setStatusPollingSuspended(StatusBlockPart aPart, bool aSuspended)
+{
+  mStatusPollingSuspended[aPart] = aSuspended;
+}
+
+
+uint64_t DummyProcDriver::getNumStatusReads(StatusBlockPart aPart) const
+{
+  return mNumStatusReads[aPart];
+}
+
+
+uint64_t DummyProcDriver::getNumFailedStatusReads(StatusBlockPart aPart) const
+{
+  return mNumFailedStatusReads[aPart];
+}
+
+
+uint64_t DummyProcDriver::getNumCommits() const
+{
+  return mNumCommits;
+}
+
+
+uint64_t DummyProcDriver::getAppliedConfiguration(ConfigurationPart aPart) const
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  return mAppliedConfiguration.get(aPart, readState(aPart));
+}
+
+
+void DummyProcDriver::setAppliedConfiguration(ConfigurationPart aPart, uint64_t aHash)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  mAppliedConfiguration.set(aPart, aHash, readState(aPart));
+}
+
+
+void DummyProcDriver::setWriteVerification(bool aVerify)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  mVerifyWrites = aVerify;
+}
+
+
+void DummyProcDriver::reboot()
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  mAppliedConfiguration.clearAll();
+  setClkTtcState(kError);
+  setTxState(kError);
+  setRxState(kError);
+  setReadoutState(kError);
+  setAlgoState(kError);
+  commit();
+}
+
+
+void DummyProcDriver::reset()
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  mAppliedConfiguration.clearAll();
+  setClkTtcState(kGood);
+
+  setTxState(kError);
+  setRxState(kError);
+  setReadoutState(kError);
+  commit();
+}
+
+
+void DummyProcDriver::forceClkTtcState(ComponentState aNewState)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  setClkTtcState(aNewState);
+  commit();
+}
+
+
+void DummyProcDriver::configureRxPorts()
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  if (readState(kRegTTCState.address) == kError) {
+    setRxState(kError);
+    commit();
+    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure rx ports - no clock!");
+  }
+  else {
+    setRxState(kGood);
+    commit();
+  }
+}
+
+
+void DummyProcDriver::forceRxPortsState(ComponentState aNewState)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  setRxState(aNewState);
+  commit();
+}
+
+
+void DummyProcDriver::configureTxPorts()
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  if (readState(kRegTTCState.address) == kError) {
+    setTxState(kError);
+    commit();
+    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure tx ports - no clock!");
+  }
+  else {
+    setTxState(kGood);
+    commit();
+  }
+}
+
+
+void DummyProcDriver::forceTxPortsState(ComponentState aNewState)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  setTxState(aNewState);
+  commit();
+}
+
+
+void DummyProcDriver::configureReadout()
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  if (readState(kRegTTCState.address) == kError) {
+    setReadoutState(kError);
+    commit();
+    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure readout block - no clock!");
+  }
+  else {
+    setReadoutState(kGood);
+    commit();
+  }
+}
+
+
+void DummyProcDriver::forceReadoutState(ComponentState aNewState)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  setReadoutState(aNewState);
+  commit();
+}
+
+
+void DummyProcDriver::configureAlgo()
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  if (readState(kRegTTCState.address) == kError) {
+    setReadoutState(kError);
+    commit();
+    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure algo - no clock!");
+  }
+  else {
+    setAlgoState(kGood);
+    commit();
+  }
+}
+
+
+void DummyProcDriver::forceAlgoState(ComponentState aNewState)
+{
+  boost::lock_guard<boost::mutex> lGuard(mConfigurationMutex);
+  setAlgoState(aNewState);
+  commit();
+}
+
+
+DummyRegisterMap& DummyProcDriver::getRegisterMap()
+{
+  return mRegisters;
+}
+
+
+void DummyProcDriver::setClkTtcState(ComponentState aNewState)
+{
+  const bool lError = (aNewState == ComponentState::kError);
+
+  mTransaction.write(kRegTTCState, aNewState);
+  mTransaction.write(kRegTTCClk40Locked, !lError);
+  mTransaction.write(kRegTTCClk40Stopped, lError);
+  mTransaction.write(kRegTTCBC0Locked, !lError);
+  mTransaction.write(kRegTTCErrSingleBit, lError ? 42 : 0);
+  mTransaction.write(kRegTTCErrDoubleBit, lError ? 4 : 0);
+}
+
+
+void DummyProcDriver::setRxState(ComponentState aNewState)
+{
+  mAppliedConfiguration.clear(kRxConfig);
+  uint32_t lStatusWord = 0x0;
+  uint32_t lCrcErrCount = 0;
+  switch (aNewState) {
     case ComponentState::kGood :
-      return ReadoutStatus(true, tts::kReady, 0xcafebeef);
+      lStatusWord = kRxLockedBit | kRxAlignedBit;
+      break;
     case ComponentState::kWarning :
-      return ReadoutStatus(true, tts::kWarning, 0xcafebeef);
+      lStatusWord = kRxLockedBit | kRxAlignedBit | kRxWarningBit;
+      break;
     case ComponentState::kError :
-      return ReadoutStatus(false, tts::kError, 0xcafe0000);
-    // Not reachable = throw
+      lStatusWord = kRxWarningBit;
+      lCrcErrCount = 42;
+      break;
     case ComponentState::kNotReachable :
       break;
   }
-  XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (readout block).");
+
+  mTransaction.write(kRegRxState, aNewState);
+  mTransaction.fill(kAddrRxChannelStatus, kMaxChannels, lStatusWord);
+  mTransaction.fill(kAddrRxCrcErrors, kMaxChannels, lCrcErrCount);
 }
 
 
-DummyProcDriver::RxPortStatus DummyProcDriver::getRxPortStatus(uint32_t aChannelId) const
+void DummyProcDriver::setTxState(ComponentState aNewState)
 {
-  switch (mRxState) {
+  mAppliedConfiguration.clear(kTxConfig);
+  uint32_t lStatusWord = 0x0;
+  switch (aNewState) {
     case ComponentState::kGood :
+      lStatusWord = kTxOperatingBit;
+      break;
     case ComponentState::kWarning :
-      return RxPortStatus(true, true, 0, mRxState == ComponentState::kWarning);
+      lStatusWord = kTxOperatingBit | kTxWarningBit;
+      break;
     case ComponentState::kError :
-      return RxPortStatus(false, false, 42, true);
+      lStatusWord = kTxWarningBit;
+      break;
     case ComponentState::kNotReachable :
       break;
   }
-  XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (rx port " + boost::lexical_cast<std::string>(aChannelId) + ").");
+
+  mTransaction.write(kRegTxState, aNewState);
+  mTransaction.fill(kAddrTxChannelStatus, kMaxChannels, lStatusWord);
 }
 
 
-DummyProcDriver::TxPortStatus DummyProcDriver::getTxPortStatus(uint32_t aChannelId) const
+void DummyProcDriver::setReadoutState(ComponentState aNewState)
 {
-  switch (mTxState) {
+  namespace tts=swatch::core::tts;
+
+  mAppliedConfiguration.clear(kReadoutConfig);
+  mTransaction.write(kRegReadoutState, aNewState);
+  switch (aNewState) {
     case ComponentState::kGood :
-      return TxPortStatus(true, false);
+      mTransaction.write(kRegReadoutAMCCoreReady, true);
+      mTransaction.write(kRegReadoutTTSState, tts::kReady);
+      mTransaction.write(kRegReadoutEventCounter, 0xcafebeef);
+      break;
     case ComponentState::kWarning :
-      return TxPortStatus(true, true);
+      mTransaction.write(kRegReadoutAMCCoreReady, true);
+      mTransaction.write(kRegReadoutTTSState, tts::kWarning);
+      mTransaction.write(kRegReadoutEventCounter, 0xcafebeef);
+      break;
     case ComponentState::kError :
-      return TxPortStatus(false, true);
+      mTransaction.write(kRegReadoutAMCCoreReady, false);
+      mTransaction.write(kRegReadoutTTSState, tts::kError);
+      mTransaction.write(kRegReadoutEventCounter, 0xcafe0000);
+      break;
     case ComponentState::kNotReachable :
       break;
   }
-  XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (tx port " + boost::lexical_cast<std::string>(aChannelId) + ").");
 }
 
 
-DummyProcDriver::AlgoStatus DummyProcDriver::getAlgoStatus() const
+void DummyProcDriver::setAlgoState(ComponentState aNewState)
 {
-  int x = rand() % 40000;
-  switch (mAlgoState) {
+  mAppliedConfiguration.clear(kAlgoConfig);
+  mTransaction.write(kRegAlgoState, aNewState);
+  switch (aNewState) {
     // All good = rates below 40kHz
     case ComponentState::kGood :
-      return AlgoStatus(12e3, x);
+      mTransaction.write(kRegAlgoRateCounterA, encodeFloat(12e3));
+      mTransaction.write(kRegAlgoRateCounterBOffset, encodeFloat(0));
+      break;
     // Warning = rates between 40 and 80 kHz
     case ComponentState::kWarning :
-      return AlgoStatus(52e3, x+40000);
+      mTransaction.write(kRegAlgoRateCounterA, encodeFloat(52e3));
+      mTransaction.write(kRegAlgoRateCounterBOffset, encodeFloat(40000));
+      break;
     // Error = rates above 80 kHz
     case ComponentState::kError :
-      return AlgoStatus(85e3, x+80000);
-    // Not reachable = throw
+      mTransaction.write(kRegAlgoRateCounterA, encodeFloat(85e3));
+      mTransaction.write(kRegAlgoRateCounterBOffset, encodeFloat(80000));
+      break;
     case ComponentState::kNotReachable :
       break;
   }
-  XCEPT_RAISE(swatch::core::RuntimeError,"Problem communicating with board (algo block).");
+  mTransaction.fill(kAddrAlgoRateCounters, kMaxAlgoRateCounters, encodeFloat(0));
 }
 
 
-void DummyProcDriver::reboot()
+void DummyProcDriver::commit()
 {
-  mClkState = kError;
-  mTxState = kError;
-  mRxState = kError;
-  mReadoutState = kError;
-  mAlgoState = kError;
+  // Counted even if verification fails, since the words have been written by then
+  try {
+    mTransaction.commit(mVerifyWrites);
+  }
+  catch (...) {
+    mNumCommits++;
+    throw;
+  }
+  mNumCommits++;
 }
 
 
-void DummyProcDriver::reset()
+ComponentState DummyProcDriver::readState(uint32_t aAddress) const
 {
-  mClkState = kGood;
+  return ComponentState(mRegisters.read(aAddress));
+}
 
-  mTxState = kError;
-  mRxState = kError;
-  mReadoutState = kError;
+
+ComponentState DummyProcDriver::readState(ConfigurationPart aPart) const
+{
+  switch (aPart) {
+    case kRxConfig : return readState(kRegRxState.address);
+    case kTxConfig : return readState(kRegTxState.address);
+    case kReadoutConfig : return readState(kRegReadoutState.address);
+    case kAlgoConfig : return readState(kRegAlgoState.address);
+    case kNumConfigurationParts : break;
+  }
+  return ComponentState::kNotReachable;
 }
 
 
-void DummyProcDriver::forceClkTtcState(ComponentState aNewState)
+bool DummyProcDriver::recordStatusRead(StatusBlockPart aPart, ComponentState aState) const
 {
-  mClkState = aNewState;
+  mNumStatusReads[aPart]++;
+  if (aState != ComponentState::kNotReachable)
+    return true;
+  mNumFailedStatusReads[aPart]++;
+  return false;
 }
 
 
-void DummyProcDriver::configureRxPorts()
+DummyProcDriver::TTCStatus DummyProcDriver::decodeTTCStatus(const uint32_t* aBlock)
 {
-  if (mClkState == kError) {
-    mRxState = kError;
-    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure rx ports - no clock!");
-  }
-  else
-    mRxState = kGood;
+  TTCStatus lStatus;
+  lStatus.bunchCounter = getField(aBlock, kAddrTTCBlock, kRegTTCBunchCounter);
+  lStatus.eventCounter = getField(aBlock, kAddrTTCBlock, kRegTTCEventCounter);
+  lStatus.orbitCounter = getField(aBlock, kAddrTTCBlock, kRegTTCOrbitCounter);
+
+  lStatus.clk40Locked = getField(aBlock, kAddrTTCBlock, kRegTTCClk40Locked);
+  lStatus.clk40Stopped = getField(aBlock, kAddrTTCBlock, kRegTTCClk40Stopped);
+  lStatus.bc0Locked = getField(aBlock, kAddrTTCBlock, kRegTTCBC0Locked);
+  lStatus.errSingleBit = getField(aBlock, kAddrTTCBlock, kRegTTCErrSingleBit);
+  lStatus.errDoubleBit = getField(aBlock, kAddrTTCBlock, kRegTTCErrDoubleBit);
+
+  lStatus.warningSign = (ComponentState(getField(aBlock, kAddrTTCBlock, kRegTTCState)) != ComponentState::kGood);
+  return lStatus;
 }
 
 
-void DummyProcDriver::forceRxPortsState(ComponentState aNewState)
+DummyProcDriver::ReadoutStatus DummyProcDriver::decodeReadoutStatus(const uint32_t* aBlock)
 {
-  mRxState = aNewState;
+  return ReadoutStatus(getField(aBlock, kAddrReadoutBlock, kRegReadoutAMCCoreReady),
+                       swatch::core::tts::State(getField(aBlock, kAddrReadoutBlock, kRegReadoutTTSState)),
+                       getField(aBlock, kAddrReadoutBlock, kRegReadoutEventCounter));
 }
 
 
-void DummyProcDriver::configureTxPorts()
+DummyProcDriver::AlgoStatus DummyProcDriver::decodeAlgoStatus(const uint32_t* aBlock)
 {
-  if (mClkState == kError) {
-    mTxState = kError;
-    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure tx ports - no clock!");
-  }
-  else
-    mTxState = kGood;
+  // Rate counter B fluctuates by up to 40kHz above its offset
+  int x = rand() % 40000;
+  return AlgoStatus(decodeFloat(getField(aBlock, kAddrAlgoBlock, kRegAlgoRateCounterA)),
+                    decodeFloat(getField(aBlock, kAddrAlgoBlock, kRegAlgoRateCounterBOffset)) + x);
 }
 
 
-void DummyProcDriver::forceTxPortsState(ComponentState aNewState)
+bool DummyProcDriver::TTCStatus::operator==(const TTCStatus& aOther) const
 {
-  mTxState = aNewState;
+  return (bunchCounter == aOther.bunchCounter) && (eventCounter == aOther.eventCounter) && (orbitCounter == aOther.orbitCounter)
+      && (clk40Locked == aOther.clk40Locked) && (clk40Stopped == aOther.clk40Stopped) && (bc0Locked == aOther.bc0Locked)
+      && (errSingleBit == aOther.errSingleBit) && (errDoubleBit == aOther.errDoubleBit) && (warningSign == aOther.warningSign);
 }
 
 
-void DummyProcDriver::configureReadout()
+bool DummyProcDriver::ReadoutStatus::operator==(const ReadoutStatus& aOther) const
 {
-  if (mClkState == kError) {
-    mReadoutState = kError;
-    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure readout block - no clock!");
-  }
-  else
-    mReadoutState = kGood;
+  return (amcCoreReady == aOther.amcCoreReady) && (ttsState == aOther.ttsState) && (eventCounter == aOther.eventCounter);
 }
 
 
-void DummyProcDriver::forceReadoutState(ComponentState aNewState)
+bool DummyProcDriver::RxPortStatus::operator==(const RxPortStatus& aOther) const
 {
-  mReadoutState = aNewState;
+  return (isLocked == aOther.isLocked) && (isAligned == aOther.isAligned) && (crcErrCount == aOther.crcErrCount) && (warningSign == aOther.warningSign);
 }
 
 
-void DummyProcDriver::configureAlgo()
+bool DummyProcDriver::TxPortStatus::operator==(const TxPortStatus& aOther) const
 {
-  if (mClkState == kError) {
-    mReadoutState = kError;
-    XCEPT_RAISE(swatch::core::RuntimeError,"Couldn't configure algo - no clock!");
-  }
-  else
-    mAlgoState = kGood;
+  return (isOperating == aOther.isOperating) && (warningSign == aOther.warningSign);
 }
 
 
-void DummyProcDriver::forceAlgoState(ComponentState aNewState)
+DummyProcDriver::StatusBlock::StatusBlock(size_t aNumRxChannels, size_t aNumTxChannels, size_t aNumAlgoRateCounters) :
+  ttcReachable(false),
+  readoutReachable(false),
+  readout(false, swatch::core::tts::kUnknown, 0),
+  algoReachable(false),
+  algo(0.0, 0.0),
+  algoRateCounters(aNumAlgoRateCounters, 0.0),
+  rxReachable(false),
+  rxIsLocked(aNumRxChannels, 0),
+  rxIsAligned(aNumRxChannels, 0),
+  rxCrcErrCount(aNumRxChannels, 0),
+  rxWarningSign(aNumRxChannels, 0),
+  txReachable(false),
+  txIsOperating(aNumTxChannels, 0),
+  txWarningSign(aNumTxChannels, 0),
+  channelWords(std::max(aNumRxChannels, aNumTxChannels), 0x0)
 {
-  mAlgoState = aNewState;
 }
 
 
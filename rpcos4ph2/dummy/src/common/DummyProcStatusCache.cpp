@@ -0,0 +1,245 @@
+
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
+
+
+#include <algorithm>
+
+#include "boost/bind.hpp"
+#include "boost/lexical_cast.hpp"
+#include "swatch/core/exception.hpp"
+
+#include "rpcos4ph2/dummy/DummyMonitoringSweep.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyProcStatusCache::DummyProcStatusCache(const DummyProcDriver& aDriver, size_t aNumRxChannels, size_t aNumTxChannels, size_t aNumAlgoRateCounters) :
+  mDriver(aDriver),
+  mBlock(aNumRxChannels, aNumTxChannels, aNumAlgoRateCounters),
+  mPrefetched(false),
+  mSweep(NULL),
+  mBoard(0),
+  mUnavailable(false)
+{
+  std::fill(mValid, mValid + DummyProcDriver::kNumStatusBlockParts, false);
+  std::fill(mReadCommits, mReadCommits + DummyProcDriver::kNumStatusBlockParts, 0);
+  std::fill(mRequested, mRequested + DummyProcDriver::kNumStatusBlockParts, false);
+}
+
+
+DummyProcStatusCache::~DummyProcStatusCache()
+{
+}
+
+
+boost::optional<DummyProcDriver::TTCStatus> DummyProcStatusCache::getTTCStatus()
+{
+  if (!refresh(DummyProcDriver::kTTCPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+
+  if (!mBlock.ttcReachable)
+    return boost::none;
+  return mBlock.ttc;
+}
+
+
+boost::optional<DummyProcDriver::ReadoutStatus> DummyProcStatusCache::getReadoutStatus()
+{
+  if (!refresh(DummyProcDriver::kReadoutPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+
+  if (!mBlock.readoutReachable)
+    return boost::none;
+  return mBlock.readout;
+}
+
+
+boost::optional<DummyProcDriver::AlgoStatus> DummyProcStatusCache::getAlgoStatus()
+{
+  if (!refresh(DummyProcDriver::kAlgoPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+
+  if (!mBlock.algoReachable)
+    return boost::none;
+  return mBlock.algo;
+}
+
+
+bool DummyProcStatusCache::getAlgoRateCounters(std::vector<float>& aValues)
+{
+  if (!refresh(DummyProcDriver::kAlgoPart))
+    return false;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+
+  if (!mBlock.algoReachable)
+    return false;
+  if (aValues.size() > mBlock.algoRateCounters.size())
+    XCEPT_RAISE(swatch::core::RuntimeError,"Requested " + boost::lexical_cast<std::string>(aValues.size()) + " algo rate counters, but only " + boost::lexical_cast<std::string>(mBlock.algoRateCounters.size()) + " are cached.");
+  std::copy(mBlock.algoRateCounters.begin(), mBlock.algoRateCounters.begin() + aValues.size(), aValues.begin());
+  return true;
+}
+
+
+boost::optional<DummyProcDriver::RxPortStatus> DummyProcStatusCache::getRxPortStatus(uint32_t aChannelId)
+{
+  if (!refresh(DummyProcDriver::kRxPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+
+  if (!mBlock.rxReachable)
+    return boost::none;
+  return DummyProcDriver::RxPortStatus(mBlock.rxIsLocked.at(aChannelId), mBlock.rxIsAligned.at(aChannelId), mBlock.rxCrcErrCount.at(aChannelId), mBlock.rxWarningSign.at(aChannelId));
+}
+
+
+boost::optional<DummyProcDriver::TxPortStatus> DummyProcStatusCache::getTxPortStatus(uint32_t aChannelId)
+{
+  if (!refresh(DummyProcDriver::kTxPart))
+    return boost::none;
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+
+  if (!mBlock.txReachable)
+    return boost::none;
+  return DummyProcDriver::TxPortStatus(mBlock.txIsOperating.at(aChannelId), mBlock.txWarningSign.at(aChannelId));
+}
+
+
+uint64_t DummyProcStatusCache::readFirmwareVersion()
+{
+  return call<uint64_t>(boost::bind(&DummyProcDriver::getFirmwareVersion, &mDriver), "firmware version");
+}
+
+
+bool DummyProcStatusCache::probe(DummyProcDriver::StatusBlockPart aPart)
+{
+  try {
+    return call<bool>([this, aPart] () { return mDriver.probe(aPart); }, "probe");
+  }
+  catch (const swatch::core::RuntimeError&) {
+    return false;
+  }
+}
+
+
+void DummyProcStatusCache::attach(DummyMonitoringSweep* aSweep, size_t aBoard)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  mSweep = aSweep;
+  mBoard = aBoard;
+}
+
+
+void DummyProcStatusCache::prefetch()
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  for (size_t i = 0; i < DummyProcDriver::kNumStatusBlockParts; i++) {
+    mValid[i] = false;
+    if (mRequested[i])
+      refreshIfStale(DummyProcDriver::StatusBlockPart(i));
+    mRequested[i] = false;
+  }
+  mPrefetched = true;
+}
+
+
+void DummyProcStatusCache::startCycle()
+{
+  if (mUnavailable)
+    return;
+
+  // The first board to start a cycle runs the sweep, which prefetches every board's status concurrently
+  DummyMonitoringSweep* lSweep = NULL;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    if (!mPrefetched)
+      lSweep = mSweep;
+  }
+  if (lSweep != NULL)
+    lSweep->run();
+
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  if (mPrefetched)
+    mPrefetched = false;
+  else
+    std::fill(mValid, mValid + DummyProcDriver::kNumStatusBlockParts, false);
+}
+
+
+void DummyProcStatusCache::setUnavailable(bool aUnavailable)
+{
+  mUnavailable = aUnavailable;
+}
+
+
+bool DummyProcStatusCache::refresh(DummyProcDriver::StatusBlockPart aPart)
+{
+  if (mUnavailable)
+    return false;
+
+  DummyMonitoringSweep* lSweep = NULL;
+  size_t lBoard = 0;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    mRequested[aPart] = true;
+    if (mValid[aPart] && (mReadCommits[aPart] == mDriver.getNumCommits()))
+      return true;
+    if (mSweep == NULL) {
+      refreshIfStale(aPart);
+      return true;
+    }
+    lSweep = mSweep;
+    lBoard = mBoard;
+  }
+
+  // N.B. mMutex mustn't be held here, since the sweep's worker locks it
+  return lSweep->run(lBoard, boost::bind(&DummyProcStatusCache::readPart, this, aPart));
+}
+
+
+void DummyProcStatusCache::readPart(DummyProcDriver::StatusBlockPart aPart)
+{
+  boost::lock_guard<boost::mutex> lGuard(mMutex);
+  refreshIfStale(aPart);
+}
+
+
+template <typename T>
+T DummyProcStatusCache::call(const boost::function<T ()>& aFunction, const std::string& aDescription)
+{
+  DummyMonitoringSweep* lSweep = NULL;
+  size_t lBoard = 0;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    lSweep = mSweep;
+    lBoard = mBoard;
+  }
+  if (lSweep == NULL)
+    return aFunction();
+
+  const boost::optional<T> lResult = lSweep->call<T>(lBoard, aFunction);
+  if (!lResult)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Board didn't respond to " + aDescription + " read within the monitoring deadline");
+  return *lResult;
+}
+
+
+void DummyProcStatusCache::refreshIfStale(DummyProcDriver::StatusBlockPart aPart)
+{
+  // Commit count is read first, so that a change committed during the read triggers another one
+  const uint64_t lNumCommits = mDriver.getNumCommits();
+  if (mValid[aPart] && (mReadCommits[aPart] == lNumCommits))
+    return;
+
+  mDriver.readStatus(mBlock, aPart);
+  mReadCommits[aPart] = lNumCommits;
+  mValid[aPart] = true;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
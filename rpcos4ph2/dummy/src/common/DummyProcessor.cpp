@@ -4,12 +4,18 @@
 // SWATCH headers
 #include "swatch/action/CommandSequence.hpp"
 #include "swatch/core/Factory.hpp"
+#include "swatch/core/MetricConditions.hpp"
 #include "swatch/core/MetricSnapshot.hpp"
 #include "swatch/action/StateMachine.hpp"
 #include "swatch/processor/PortCollection.hpp"
 #include "swatch/processor/ProcessorStub.hpp"
 #include "rpcos4ph2/dummy/DummyAlgo.hpp"
+#include "rpcos4ph2/dummy/DummyBoardBuilder.hpp"
+#include "rpcos4ph2/dummy/DummyForkJoinCommand.hpp"
+#include "rpcos4ph2/dummy/DummyPortAggregator.hpp"
+#include "rpcos4ph2/dummy/DummyPortMask.hpp"
 #include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
 #include "rpcos4ph2/dummy/DummyProcessorCommands.hpp"
 #include "rpcos4ph2/dummy/DummyReadout.hpp"
 #include "rpcos4ph2/dummy/DummyRxPort.hpp"
@@ -23,9 +29,16 @@
 
 // Boost Headers
 #include <boost/assign.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
 #include <boost/foreach.hpp>
 
+// log4cplus headers
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
 // C++ Headers
+#include <algorithm>
 #include <iomanip>
 
 
@@ -36,41 +49,104 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
+DummyProcessor::Components::Components(const swatch::processor::ProcessorStub& aStub)
+{
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  driver.reset(new DummyProcDriver());
+
+  // Status cache, sized so that the per-channel arrays can be indexed by port number
+  size_t lNumRxChannels = 0, lNumTxChannels = 0;
+  for (auto it = aStub.rxPorts.begin(); it != aStub.rxPorts.end(); it++)
+    lNumRxChannels = std::max<size_t>(lNumRxChannels, it->number + 1);
+  for (auto it = aStub.txPorts.begin(); it != aStub.txPorts.end(); it++)
+    lNumTxChannels = std::max<size_t>(lNumTxChannels, it->number + 1);
+  statusCache.reset(new DummyProcStatusCache(*driver, lNumRxChannels, lNumTxChannels, DummyAlgo::kNumRateCounters));
+
+  ttc.reset(new DummyTTC(*statusCache));
+  readout.reset(new DummyReadoutInterface(*statusCache));
+  algo.reset(new DummyAlgo(*statusCache));
+
+  portAggregator.reset(new DummyPortAggregator(aStub.rxPorts.size()));
+  portMask.reset(new DummyPortMask(aStub.rxPorts.size()));
+  rxPorts.reserve(aStub.rxPorts.size());
+  for (auto it = aStub.rxPorts.begin(); it != aStub.rxPorts.end(); it++)
+    rxPorts.push_back(std::unique_ptr<DummyRxPort>(new DummyRxPort(it->id, it->number, rxPorts.size(), *statusCache, *portAggregator, *portMask)));
+  txPorts.reserve(aStub.txPorts.size());
+  for (auto it = aStub.txPorts.begin(); it != aStub.txPorts.end(); it++)
+    txPorts.push_back(std::unique_ptr<DummyTxPort>(new DummyTxPort(it->id, it->number, *statusCache)));
+
+  buildTime = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - lStartTime);
+}
+
+
+DummyProcessor::Components::~Components()
+{
+}
+
+
 DummyProcessor::DummyProcessor(const swatch::core::AbstractStub& aStub) :
   Processor(aStub),
-  mDriver(new DummyProcDriver())
+  mMetricCircuitBreakerOpen(registerMetric<bool>("circuitBreakerOpen")),
+  mMetricConsecutiveFailures(registerMetric<uint32_t>("consecutiveFailures")),
+  mMetricCircuitBreakerTrips(registerMetric<uint32_t>("circuitBreakerTrips")),
+  mMetricPollingBackoff(registerMetric<float>("statusPollingBackoff"))
 {
+  const boost::chrono::steady_clock::time_point lStartTime = boost::chrono::steady_clock::now();
+
+  // 0) Driver, status cache, interfaces & ports: either built ahead by the system (possibly on another thread), or built now
+  std::unique_ptr<Components> lComponents(DummyBoardBuilder::takeProcessorComponents(getStub()));
+  mDriver.reset(lComponents->driver.release());
+  mStatusCache.reset(lComponents->statusCache.release());
+  mPortAggregator.reset(lComponents->portAggregator.release());
+  mPortMask.reset(lComponents->portMask.release());
+
+  // Refresh timers, whose periods follow the schedule engaged by the cell (see engage)
+  mRefreshTimers.add(lComponents->ttc->getId(), lComponents->ttc->getRefreshTimer());
+  mRefreshTimers.add(lComponents->readout->getId(), lComponents->readout->getRefreshTimer());
+  mRefreshTimers.add(lComponents->algo->getId(), lComponents->algo->getRefreshTimer());
+  for (auto it = lComponents->rxPorts.begin(); it != lComponents->rxPorts.end(); it++)
+    mRefreshTimers.add("inputPorts." + (*it)->getId(), (*it)->getRefreshTimer());
+  for (auto it = lComponents->txPorts.begin(); it != lComponents->txPorts.end(); it++)
+    mRefreshTimers.add("outputPorts." + (*it)->getId(), (*it)->getRefreshTimer());
+  mRefreshTimers.add("firmwareVersion", mFirmwareVersionTimer);
+
   // 1) Interfaces
-  registerInterface( new DummyTTC(*mDriver) );
-  registerInterface( new DummyReadoutInterface(*mDriver) );
-  registerInterface( new DummyAlgo(*mDriver) );
+  registerInterface( lComponents->ttc.release() );
+  registerInterface( lComponents->readout.release() );
+  registerInterface( lComponents->algo.release() );
   registerInterface( new swatch::processor::InputPortCollection() );
   registerInterface( new swatch::processor::OutputPortCollection() );
 
-  const swatch::processor::ProcessorStub& stub = getStub();
-
-  for (auto it = stub.rxPorts.begin(); it != stub.rxPorts.end(); it++)
-    getInputPorts().addPort(new DummyRxPort(it->id, it->number, *mDriver));
-  for (auto it = stub.txPorts.begin(); it != stub.txPorts.end(); it++)
-    getOutputPorts().addPort(new DummyTxPort(it->id, it->number, *mDriver));
+  for (auto it = lComponents->rxPorts.begin(); it != lComponents->rxPorts.end(); it++)
+    getInputPorts().addPort(it->release());
+  for (auto it = lComponents->txPorts.begin(); it != lComponents->txPorts.end(); it++)
+    getOutputPorts().addPort(it->release());
 
-  // 2) Monitoring
+  // 2) Monitoring: port totals are kept up to date by the ports themselves, and read by the complex metrics' calculate functions
   std::vector<swatch::core::MonitorableObject*> lInputPorts;
   std::vector<swatch::core::AbstractMetric*> lCRCErrorMetrics;
   for (auto lIt=getInputPorts().getPorts().begin(); lIt != getInputPorts().getPorts().end(); lIt++) {
     lCRCErrorMetrics.push_back(&(*lIt)->getMetric(swatch::processor::InputPort::kMetricIdCRCErrors));
     lInputPorts.push_back(*lIt);
   }
-  registerComplexMetric<uint32_t>("totalCRCErrors", lCRCErrorMetrics.begin(), lCRCErrorMetrics.end(), swatch::core::ComplexMetric<uint32_t>::CalculateFunction_t(&sumUpCRCErrors), &filterOutMaskedPorts);
-  registerComplexMetric<uint32_t>("portsInError", lInputPorts.begin(), lInputPorts.end(), swatch::core::ComplexMetric<uint32_t>::CalculateFunction2_t(&countObjectsInError), &filterOutMaskedPorts);
+  registerComplexMetric<uint32_t>("totalCRCErrors", lCRCErrorMetrics.begin(), lCRCErrorMetrics.end(), swatch::core::ComplexMetric<uint32_t>::CalculateFunction_t(boost::bind(&DummyPortAggregator::calculateTotalCRCErrors, mPortAggregator.get(), _1)), &filterOutMaskedPorts);
+  registerComplexMetric<uint32_t>("portsInError", lInputPorts.begin(), lInputPorts.end(), swatch::core::ComplexMetric<uint32_t>::CalculateFunction2_t(boost::bind(&DummyPortAggregator::calculateNumberInError, mPortAggregator.get(), _1)), &filterOutMaskedPorts);
+  updatePortMask();
+
+  // Throttled monitoring is flagged as a warning, so that it's distinguishable from a board in error
+  setWarningCondition<>(mMetricCircuitBreakerOpen, swatch::core::EqualCondition<bool>(true));
 
   // 3) Commands
   swatch::action::Command& reboot = registerCommand<DummyResetCommand>("reboot");
   swatch::action::Command& reset = registerCommand<DummyResetCommand>("reset");
-  swatch::action::Command& cfgTx = registerCommand<DummyConfigureTxCommand>("configureTx");
-  swatch::action::Command& cfgRx = registerCommand<DummyConfigureRxCommand>("configureRx");
-  swatch::action::Command& cfgDaq = registerCommand<DummyConfigureDaqCommand>("configureDaq");
-  swatch::action::Command& cfgAlgo = registerCommand<DummyConfigureAlgoCommand>("configureAlgo");
+  AbstractConfigureCommand& cfgTx = registerCommand<DummyConfigureTxCommand>("configureTx");
+  AbstractConfigureCommand& cfgRx = registerCommand<DummyConfigureRxCommand>("configureRx");
+  AbstractConfigureCommand& cfgDaq = registerCommand<DummyConfigureDaqCommand>("configureDaq");
+  AbstractConfigureCommand& cfgAlgo = registerCommand<DummyConfigureAlgoCommand>("configureAlgo");
+  // After a reset, the readout, algo, rx & tx blocks are independent of each other, so they're configured in parallel
+  DummyForkJoinCommand& cfgBlocks = registerCommand<DummyForkJoinCommand>("configureBlocks");
+  cfgBlocks.addBranch(cfgDaq).addBranch(cfgAlgo).addBranch(cfgRx).addBranch(cfgTx);
 
   registerCommand<DummyProcessorForceClkTtcStateCommand>("forceClkTtcState");
   registerCommand<DummyProcessorForceRxPortsStateCommand>("forceRxPortsState");
@@ -80,7 +156,7 @@ DummyProcessor::DummyProcessor(const swatch::core::AbstractStub& aStub) :
 
   // 4) Command sequences
   swatch::action::CommandSequence& cfgSeq = registerSequence("configPartA", reset).then(cfgDaq).then(cfgTx);
-  registerSequence("fullReconfigure", reset).then(cfgDaq).then(cfgAlgo).then(cfgRx).then(cfgTx);
+  registerSequence("fullReconfigure", reset).then(cfgBlocks);
 
   // 5) State machines
   swatch::processor::RunControlFSM& lFSM = getRunControlFSM();
@@ -89,6 +165,12 @@ DummyProcessor::DummyProcessor(const swatch::core::AbstractStub& aStub) :
   lFSM.configure.add(cfgAlgo);
   lFSM.align.add(cfgRx);
   lFSM.fsm.addTransition("dummyNoOp", swatch::processor::RunControlFSM::kStateAligned, swatch::processor::RunControlFSM::kStateInitial);
+
+  // 6) Start-up report
+  const boost::chrono::milliseconds lDuration = boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now() - lStartTime);
+  LOG4CPLUS_INFO(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Processor '" << getId() << "' constructed in " << lDuration.count() << " ms "
+      << "(components built in " << (lComponents->buildTime.count() / 1000) << " ms); "
+      << (mDriver->getRegisterMap().getResidentBytes() / 1024) << " kB of register space resident; process RSS now " << (getProcessResidentBytes() / (1024 * 1024)) << " MB");
 }
 
 
@@ -103,9 +185,83 @@ std::string DummyProcessor::firmwareInfo() const
 }
 
 
+void DummyProcessor::updatePortMask()
+{
+  const std::deque<swatch::processor::InputPort*>& lPorts = getInputPorts().getPorts();
+  for (size_t i = 0; i < lPorts.size(); i++) {
+    const bool lIsMasked = lPorts.at(i)->isMasked();
+    mPortMask->setMasked(i, lIsMasked);
+    mPortAggregator->setMasked(i, lIsMasked);
+  }
+}
+
+
+void DummyProcessor::expireRefreshTimers()
+{
+  mRefreshTimers.expire();
+}
+
+
+void DummyProcessor::engage(const swatch::action::GateKeeper& aGateKeeper)
+{
+  mRefreshTimers.engage(aGateKeeper, getGateKeeperContexts());
+  mDriver->setWriteVerification(readBoolParameter(aGateKeeper, getGateKeeperContexts(), "verifyWrites", false));
+  dynamic_cast<DummyForkJoinCommand&>(getCommand("configureBlocks")).engage(aGateKeeper, getGateKeeperContexts());
+}
+
+
 void DummyProcessor::retrieveMetricValues()
 {
-  setMetricValue<uint64_t>(mMetricFirmwareVersion, mDriver->getFirmwareVersion());
+  // Cached status is re-read in each cycle (unless the monitoring sweep has just prefetched it). Hardware reads below go
+  // through the cache too, so that they're bounded by the sweep's deadline
+  mStatusCache->startCycle();
+
+  // Refresh periods depend on the FSM state. N.B. Relies on the board's metrics being updated before those of its
+  // interfaces & ports in each cycle
+  mRefreshTimers.update(getStatus().getState());
+
+  // Circuit breakers: once a part of the board (e.g. the readout block) has failed in several consecutive cycles, its status
+  // (i.e. that of the interface or ports it covers) isn't polled until a probe with exponential backoff shows that it responds
+  // again; the other parts are still polled as usual.
+  // N.B. Relies on the board's metrics being updated before those of its interfaces & ports in each cycle
+  bool lAnyBreakerOpen = false;
+  size_t lMaxConsecutiveFailures = 0;
+  uint32_t lNumTrips = 0;
+  boost::chrono::milliseconds lMaxBackoff(0);
+  for (size_t i = 0; i < DummyProcDriver::kNumStatusBlockParts; i++) {
+    const DummyProcDriver::StatusBlockPart lPart = DummyProcDriver::StatusBlockPart(i);
+    DummyCircuitBreaker& lBreaker = mCircuitBreakers[i];
+    lBreaker.recordStatusReads(mDriver->getNumStatusReads(lPart), mDriver->getNumFailedStatusReads(lPart));
+    if (lBreaker.isProbeDue())
+      lBreaker.recordProbe(mStatusCache->probe(lPart));
+    const bool lBreakerOpen = (lBreaker.getState() != DummyCircuitBreaker::kClosed);
+    mDriver->setStatusPollingSuspended(lPart, lBreakerOpen);
+
+    lMaxConsecutiveFailures = std::max(lMaxConsecutiveFailures, lBreaker.getNumConsecutiveFailures());
+    lNumTrips += lBreaker.getNumTrips();
+    if (lBreakerOpen) {
+      lAnyBreakerOpen = true;
+      lMaxBackoff = std::max(lMaxBackoff, lBreaker.getBackoff());
+    }
+  }
+
+  setMetricValue<bool>(mMetricCircuitBreakerOpen, lAnyBreakerOpen);
+  setMetricValue<uint32_t>(mMetricConsecutiveFailures, uint32_t(lMaxConsecutiveFailures));
+  setMetricValue<uint32_t>(mMetricCircuitBreakerTrips, lNumTrips);
+  setMetricValue<float>(mMetricPollingBackoff, float(lMaxBackoff.count()) / 1000);
+
+  // Ports whose monitoring is disabled aren't updated, so are excluded from the port totals rather than left unknown
+  const bool lAllPortsDisabled = (getInputPorts().getMonitoringStatus() == swatch::core::monitoring::kDisabled);
+  const std::deque<swatch::processor::InputPort*>& lPorts = getInputPorts().getPorts();
+  for (size_t i = 0; i < lPorts.size(); i++)
+    mPortAggregator->setDisabled(i, lAllPortsDisabled || (lPorts.at(i)->getMonitoringStatus() == swatch::core::monitoring::kDisabled));
+
+  // Firmware version is static, so typically re-read much less often than the other registers
+  if (mFirmwareVersionTimer.isDue() || !mFirmwareVersion) {
+    mFirmwareVersion.reset();
+    mFirmwareVersion = mStatusCache->readFirmwareVersion();
+  }
+  setMetricValue<uint64_t>(mMetricFirmwareVersion, *mFirmwareVersion);
 }
 
 
@@ -2,11 +2,9 @@
 #include "rpcos4ph2/dummy/DummyProcessorCommands.hpp"
 
 
-// XDAQ headers
-#include "xdata/Vector.h"
-
 // SWATCH headers
 #include "rpcos4ph2/dummy/DummyProcessor.hpp"
+#include "rpcos4ph2/dummy/DummyPortMask.hpp"
 #include "rpcos4ph2/dummy/DummyProcDriver.hpp"
 #include "swatch/processor/Port.hpp"
 #include "swatch/processor/PortCollection.hpp"
@@ -32,6 +30,7 @@ void DummyRebootCommand::runAction(bool aGoIntoError)
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   lDriver.reboot();
+  getActionable<DummyProcessor>().expireRefreshTimers();
 }
 
 
@@ -49,9 +48,12 @@ DummyResetCommand::~DummyResetCommand()
 
 void DummyResetCommand::runAction(bool aGoIntoError)
 {
+  getActionable<DummyProcessor>().updatePortMask();
+
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   if (!aGoIntoError)
     lDriver.reset();
+  getActionable<DummyProcessor>().expireRefreshTimers();
 }
 
 
@@ -71,14 +73,20 @@ void DummyConfigureTxCommand::runAction(bool aGoIntoError)
 {
   DummyProcessor& lProc = getActionable<DummyProcessor>();
 
-  xdata::Vector<xdata::String> lPorts;
-  for (auto lIt=lProc.getOutputPorts().getPorts().begin(); lIt != lProc.getOutputPorts().getPorts().end(); lIt++)
-    lPorts.push_back((*lIt)->getId());
-  addExecutionDetails("ports", lPorts);
+  mIncludedPorts.assign(lProc.getOutputPorts().getPorts().size(), true);
+  addExecutionDetails("ports", mPortIds.get(lProc.getOutputPorts().getPorts(), mIncludedPorts));
 
   DummyProcDriver& lDriver = lProc.getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureTxPorts();
+    lDriver.setAppliedConfiguration(DummyProcDriver::kTxConfig, getConfigurationHash());
+  }
+  getActionable<DummyProcessor>().expireRefreshTimers();
+}
+
+uint64_t DummyConfigureTxCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyProcessor>().getDriver().getAppliedConfiguration(DummyProcDriver::kTxConfig);
 }
 
 
@@ -97,17 +105,36 @@ DummyConfigureRxCommand::~DummyConfigureRxCommand()
 void DummyConfigureRxCommand::runAction(bool aGoIntoError)
 {
   DummyProcessor& lProc = getActionable<DummyProcessor>();
+  lProc.updatePortMask();
 
-  xdata::Vector<xdata::String> lPorts;
-  for (auto lIt=lProc.getInputPorts().getPorts().begin(); lIt != lProc.getInputPorts().getPorts().end(); lIt++) {
-    if (!(*lIt)->isMasked())
-      lPorts.push_back((*lIt)->getId());
-  }
-  addExecutionDetails("ports", lPorts);
+  const DummyPortMask& lMask = lProc.getPortMask();
+  mIncludedPorts.resize(lMask.size());
+  for (size_t i = 0; i < lMask.size(); i++)
+    mIncludedPorts.at(i) = !lMask.isMasked(i);
+  addExecutionDetails("ports", mPortIds.get(lProc.getInputPorts().getPorts(), mIncludedPorts));
 
   DummyProcDriver& lDriver = lProc.getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureRxPorts();
+    lDriver.setAppliedConfiguration(DummyProcDriver::kRxConfig, getConfigurationHash());
+  }
+  getActionable<DummyProcessor>().expireRefreshTimers();
+}
+
+uint64_t DummyConfigureRxCommand::hashInputs(uint64_t aHash)
+{
+  DummyProcessor& lProc = getActionable<DummyProcessor>();
+  lProc.updatePortMask();
+
+  const DummyPortMask& lMask = lProc.getPortMask();
+  for (size_t i = 0; i < lMask.size(); i++)
+    aHash = addToHash(aHash, lMask.isMasked(i));
+  return aHash;
+}
+
+uint64_t DummyConfigureRxCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyProcessor>().getDriver().getAppliedConfiguration(DummyProcDriver::kRxConfig);
 }
 
 
@@ -126,8 +153,16 @@ DummyConfigureDaqCommand::~DummyConfigureDaqCommand()
 void DummyConfigureDaqCommand::runAction(bool aGoIntoError)
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureReadout();
+    lDriver.setAppliedConfiguration(DummyProcDriver::kReadoutConfig, getConfigurationHash());
+  }
+  getActionable<DummyProcessor>().expireRefreshTimers();
+}
+
+uint64_t DummyConfigureDaqCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyProcessor>().getDriver().getAppliedConfiguration(DummyProcDriver::kReadoutConfig);
 }
 
 
@@ -146,8 +181,16 @@ DummyConfigureAlgoCommand::~DummyConfigureAlgoCommand()
 void DummyConfigureAlgoCommand::runAction(bool aGoIntoError)
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
-  if (!aGoIntoError)
+  if (!aGoIntoError) {
     lDriver.configureAlgo();
+    lDriver.setAppliedConfiguration(DummyProcDriver::kAlgoConfig, getConfigurationHash());
+  }
+  getActionable<DummyProcessor>().expireRefreshTimers();
+}
+
+uint64_t DummyConfigureAlgoCommand::getAppliedConfiguration()
+{
+  return getActionable<DummyProcessor>().getDriver().getAppliedConfiguration(DummyProcDriver::kAlgoConfig);
 }
 
 
@@ -167,6 +210,7 @@ swatch::action::Command::State DummyProcessorForceClkTtcStateCommand::code(const
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   lDriver.forceClkTtcState(parseState(aParamSet));
+  getActionable<DummyProcessor>().expireRefreshTimers();
   return kDone;
 }
 
@@ -187,6 +231,7 @@ swatch::action::Command::State DummyProcessorForceRxPortsStateCommand::code(cons
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   lDriver.forceRxPortsState(parseState(aParamSet));
+  getActionable<DummyProcessor>().expireRefreshTimers();
   return kDone;
 }
 
@@ -207,6 +252,7 @@ swatch::action::Command::State DummyProcessorForceTxPortsStateCommand::code(cons
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   lDriver.forceTxPortsState(parseState(aParamSet));
+  getActionable<DummyProcessor>().expireRefreshTimers();
   return kDone;
 }
 
@@ -227,6 +273,7 @@ swatch::action::Command::State DummyProcessorForceReadoutStateCommand::code(cons
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   lDriver.forceReadoutState(parseState(aParamSet));
+  getActionable<DummyProcessor>().expireRefreshTimers();
   return kDone;
 }
 
@@ -247,6 +294,7 @@ swatch::action::Command::State DummyProcessorForceAlgoStateCommand::code(const s
 {
   DummyProcDriver& lDriver = getActionable<DummyProcessor>().getDriver();
   lDriver.forceAlgoState(parseState(aParamSet));
+  getActionable<DummyProcessor>().expireRefreshTimers();
   return kDone;
 }
 
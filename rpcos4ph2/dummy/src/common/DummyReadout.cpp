@@ -2,16 +2,16 @@
 #include "rpcos4ph2/dummy/DummyReadout.hpp"
 
 
-#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
 
-DummyReadoutInterface::DummyReadoutInterface(DummyProcDriver& aDriver) :
+DummyReadoutInterface::DummyReadoutInterface(DummyProcStatusCache& aStatusCache) :
   ReadoutInterface(),
-  mDriver(aDriver)
+  mStatusCache(aStatusCache)
 {
 }
 
@@ -21,12 +21,30 @@ DummyReadoutInterface::~DummyReadoutInterface()
 }
 
 
+bool DummyReadoutInterface::isDirty() const
+{
+  return mChangeTracker.isDirty();
+}
+
+
+DummyRefreshTimer& DummyReadoutInterface::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+
 void DummyReadoutInterface::retrieveMetricValues()
 {
-  DummyProcDriver::ReadoutStatus lStatus = mDriver.getReadoutStatus();
-  setMetricValue<>(mMetricAMCCoreReady, lStatus.amcCoreReady);
-  setMetricValue<>(mMetricTTS, lStatus.ttsState);
-  setMetricValue<>(mMetricEventCounter, lStatus.eventCounter);
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyProcDriver::ReadoutStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getReadoutStatus() : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+  setMetricValue<>(mMetricAMCCoreReady, lStatus->amcCoreReady);
+  setMetricValue<>(mMetricTTS, lStatus->ttsState);
+  setMetricValue<>(mMetricEventCounter, lStatus->eventCounter);
 }
 
 
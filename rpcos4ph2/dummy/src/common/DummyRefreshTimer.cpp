@@ -0,0 +1,115 @@
+
+#include "rpcos4ph2/dummy/DummyRefreshTimer.hpp"
+
+
+#include "rpcos4ph2/dummy/DummyMonitoringSchedule.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyRefreshTimer::DummyRefreshTimer() :
+  mPeriod(0),
+  mExpired(true)
+{
+}
+
+
+DummyRefreshTimer::~DummyRefreshTimer()
+{
+}
+
+
+void DummyRefreshTimer::setPeriod(const boost::chrono::milliseconds& aPeriod)
+{
+  mPeriod = aPeriod;
+}
+
+
+const boost::chrono::milliseconds& DummyRefreshTimer::getPeriod() const
+{
+  return mPeriod;
+}
+
+
+bool DummyRefreshTimer::isDue()
+{
+  const boost::chrono::steady_clock::time_point lNow = boost::chrono::steady_clock::now();
+
+  // A tenth of the period is allowed as slack, so that jitter in the monitoring cycle doesn't skip a whole period
+  if (mExpired.exchange(false) || ((lNow - mLastRefresh) >= (mPeriod - mPeriod / 10))) {
+    mLastRefresh = lNow;
+    return true;
+  }
+  return false;
+}
+
+
+void DummyRefreshTimer::expire()
+{
+  mExpired = true;
+}
+
+
+DummyRefreshTimerSet::DummyRefreshTimerSet() :
+  mUpdated(false),
+  mSchedule(new DummyMonitoringSchedule()),
+  mScheduleChanged(false)
+{
+}
+
+
+DummyRefreshTimerSet::~DummyRefreshTimerSet()
+{
+}
+
+
+void DummyRefreshTimerSet::add(const std::string& aPath, DummyRefreshTimer& aTimer)
+{
+  mTimers.push_back(std::make_pair(aPath, &aTimer));
+  mUpdated = false;
+}
+
+
+void DummyRefreshTimerSet::engage(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts)
+{
+  boost::shared_ptr<const DummyMonitoringSchedule> lSchedule(new DummyMonitoringSchedule(aGateKeeper, aContexts));
+
+  boost::lock_guard<boost::mutex> lGuard(mScheduleMutex);
+  mSchedule = lSchedule;
+  mScheduleChanged = true;
+}
+
+
+void DummyRefreshTimerSet::update(const std::string& aState)
+{
+  boost::shared_ptr<const DummyMonitoringSchedule> lSchedule;
+  {
+    boost::lock_guard<boost::mutex> lGuard(mScheduleMutex);
+    if (mUpdated && !mScheduleChanged && (aState == mState))
+      return;
+    lSchedule = mSchedule;
+    mScheduleChanged = false;
+  }
+
+  // Values read under the previous periods may be stale under the new ones, so they're all re-read
+  for (auto lIt = mTimers.begin(); lIt != mTimers.end(); lIt++) {
+    lIt->second->setPeriod(lSchedule->getPeriod(aState, lIt->first));
+    lIt->second->expire();
+  }
+
+  mUpdated = true;
+  mState = aState;
+}
+
+
+void DummyRefreshTimerSet::expire()
+{
+  for (auto lIt = mTimers.begin(); lIt != mTimers.end(); lIt++)
+    lIt->second->expire();
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
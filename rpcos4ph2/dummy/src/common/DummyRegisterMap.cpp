@@ -0,0 +1,361 @@
+
+#include "rpcos4ph2/dummy/DummyRegisterMap.hpp"
+
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "boost/thread/locks.hpp"
+
+#include "swatch/core/exception.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+namespace {
+
+//! Count that the calling thread's round-trips are added to, if any (see RoundTripScope)
+thread_local uint32_t* tRoundTripCount = NULL;
+
+}
+
+
+DummyRegisterMap::RoundTripScope::RoundTripScope(uint32_t& aCount) :
+  mPreviousCount(tRoundTripCount)
+{
+  tRoundTripCount = &aCount;
+}
+
+
+DummyRegisterMap::RoundTripScope::~RoundTripScope()
+{
+  tRoundTripCount = mPreviousCount;
+}
+
+
+DummyRegisterMap::Register::Register(uint32_t aAddress, uint32_t aMask) :
+  address(aAddress),
+  mask(aMask)
+{
+}
+
+
+DummyRegisterMap::MaskedWord::MaskedWord(uint32_t aAddress, uint32_t aValue, uint32_t aMask) :
+  address(aAddress),
+  value(aValue),
+  mask(aMask)
+{
+}
+
+
+DummyRegisterMap::MaskedWord::MaskedWord(const Register& aRegister, uint32_t aValue) :
+  address(aRegister.address),
+  value((aValue << getShift(aRegister.mask)) & aRegister.mask),
+  mask(aRegister.mask)
+{
+}
+
+
+DummyRegisterMap::Counters::Counters() :
+  reads(0),
+  writes(0),
+  blockReads(0),
+  blockWrites(0),
+  wordsRead(0),
+  wordsWritten(0),
+  roundTrips(0)
+{
+}
+
+
+DummyRegisterMap::AtomicCounters::AtomicCounters()
+{
+  reset();
+}
+
+
+void DummyRegisterMap::AtomicCounters::reset()
+{
+  reads = 0;
+  writes = 0;
+  blockReads = 0;
+  blockWrites = 0;
+  wordsRead = 0;
+  wordsWritten = 0;
+  roundTrips = 0;
+}
+
+
+DummyRegisterMap::DummyRegisterMap(size_t aSizeInBytes) :
+  mBuffer(NULL),
+  mSizeInBytes(aSizeInBytes)
+{
+  void* lMapping = mmap(NULL, mSizeInBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (lMapping == MAP_FAILED)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Could not map register space (" + std::string(strerror(errno)) + ")");
+  mBuffer = static_cast<uint8_t*>(lMapping);
+}
+
+
+DummyRegisterMap::~DummyRegisterMap()
+{
+  munmap(mBuffer, mSizeInBytes);
+}
+
+
+size_t DummyRegisterMap::size() const
+{
+  return mSizeInBytes / sizeof(uint32_t);
+}
+
+
+size_t DummyRegisterMap::getResidentBytes() const
+{
+  const size_t lPageSize = sysconf(_SC_PAGESIZE);
+  const size_t lNrPages = (mSizeInBytes + lPageSize - 1) / lPageSize;
+
+  std::vector<unsigned char> lPageStatus(lNrPages, 0);
+  if (mincore(mBuffer, mSizeInBytes, &lPageStatus[0]) != 0)
+    return 0;
+
+  size_t lNrResidentPages = 0;
+  for (size_t i = 0; i < lNrPages; i++)
+    lNrResidentPages += (lPageStatus[i] & 0x1);
+  return lNrResidentPages * lPageSize;
+}
+
+
+void DummyRegisterMap::addRegister(const std::string& aName, const Register& aRegister)
+{
+  checkRange(aRegister.address, 1);
+  if (aRegister.mask == 0)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Register '" + aName + "' has an empty mask");
+  if (!mRegisters.insert(std::make_pair(aName, aRegister)).second)
+    XCEPT_RAISE(swatch::core::RuntimeError,"Register '" + aName + "' already defined");
+}
+
+
+const DummyRegisterMap::Register& DummyRegisterMap::getRegister(const std::string& aName) const
+{
+  std::map<std::string, Register>::const_iterator lIt = mRegisters.find(aName);
+  if (lIt == mRegisters.end())
+    XCEPT_RAISE(swatch::core::RuntimeError,"Register '" + aName + "' does not exist");
+  return lIt->second;
+}
+
+
+uint32_t DummyRegisterMap::read(uint32_t aAddress) const
+{
+  checkRange(aAddress, 1);
+  countRoundTrip();
+  mCounters.reads++;
+  mCounters.wordsRead++;
+
+  boost::shared_lock<boost::shared_mutex> lLock(mBufferMutex);
+  return loadWord(aAddress);
+}
+
+
+uint32_t DummyRegisterMap::read(const Register& aRegister) const
+{
+  return getField(read(aRegister.address), aRegister);
+}
+
+
+uint32_t DummyRegisterMap::read(const std::string& aName) const
+{
+  return read(getRegister(aName));
+}
+
+
+void DummyRegisterMap::write(uint32_t aAddress, uint32_t aValue)
+{
+  checkRange(aAddress, 1);
+  countRoundTrip();
+  mCounters.writes++;
+  mCounters.wordsWritten++;
+
+  boost::unique_lock<boost::shared_mutex> lLock(mBufferMutex);
+  storeWord(aAddress, aValue);
+}
+
+
+void DummyRegisterMap::write(const Register& aRegister, uint32_t aValue)
+{
+  if (aRegister.mask == 0xFFFFFFFF)
+    return write(aRegister.address, aValue);
+
+  // Still two round-trips (read, then write), but the word is locked in between so that no other write is lost
+  checkRange(aRegister.address, 1);
+  countRoundTrip();
+  countRoundTrip();
+  mCounters.reads++;
+  mCounters.wordsRead++;
+  mCounters.writes++;
+  mCounters.wordsWritten++;
+
+  boost::unique_lock<boost::shared_mutex> lLock(mBufferMutex);
+  const uint32_t lOldValue = loadWord(aRegister.address);
+  storeWord(aRegister.address, (lOldValue & ~aRegister.mask) | ((aValue << getShift(aRegister.mask)) & aRegister.mask));
+}
+
+
+void DummyRegisterMap::write(const std::string& aName, uint32_t aValue)
+{
+  write(getRegister(aName), aValue);
+}
+
+
+void DummyRegisterMap::readBlock(uint32_t aAddress, size_t aNrWords, uint32_t* aData) const
+{
+  checkRange(aAddress, aNrWords);
+  countRoundTrip();
+  mCounters.blockReads++;
+  mCounters.wordsRead += aNrWords;
+
+  boost::shared_lock<boost::shared_mutex> lLock(mBufferMutex);
+  std::memcpy(aData, &mBuffer[aAddress * sizeof(uint32_t)], aNrWords * sizeof(uint32_t));
+}
+
+
+void DummyRegisterMap::writeBlock(uint32_t aAddress, size_t aNrWords, const uint32_t* aData)
+{
+  checkRange(aAddress, aNrWords);
+  countRoundTrip();
+  mCounters.blockWrites++;
+  mCounters.wordsWritten += aNrWords;
+
+  boost::unique_lock<boost::shared_mutex> lLock(mBufferMutex);
+  std::memcpy(&mBuffer[aAddress * sizeof(uint32_t)], aData, aNrWords * sizeof(uint32_t));
+}
+
+
+void DummyRegisterMap::fillBlock(uint32_t aAddress, size_t aNrWords, uint32_t aValue)
+{
+  checkRange(aAddress, aNrWords);
+  countRoundTrip();
+  mCounters.blockWrites++;
+  mCounters.wordsWritten += aNrWords;
+
+  boost::unique_lock<boost::shared_mutex> lLock(mBufferMutex);
+  for (size_t i = 0; i < aNrWords; i++)
+    storeWord(aAddress + i, aValue);
+}
+
+
+void DummyRegisterMap::writeBatch(const std::vector<MaskedWord>& aWords)
+{
+  for (auto lIt = aWords.begin(); lIt != aWords.end(); lIt++)
+    checkRange(lIt->address, 1);
+
+  countRoundTrip();
+  // The whole batch is written under one lock, so that readers see either none or all of it
+  boost::unique_lock<boost::shared_mutex> lLock(mBufferMutex);
+  for (size_t i = 0; i < aWords.size(); i++) {
+    const MaskedWord& lWord = aWords.at(i);
+    if ((i == 0) || (lWord.address != (aWords.at(i - 1).address + 1)))
+      mCounters.blockWrites++;
+    mCounters.wordsWritten++;
+
+    // Partially-masked words are read-modify-writes, done on the board without a separate round-trip
+    uint32_t lValue = lWord.value;
+    if (lWord.mask != 0xFFFFFFFF)
+      lValue = (loadWord(lWord.address) & ~lWord.mask) | (lWord.value & lWord.mask);
+    storeWord(lWord.address, lValue);
+  }
+}
+
+
+void DummyRegisterMap::readBatch(const std::vector<MaskedWord>& aWords, std::vector<uint32_t>& aValues) const
+{
+  for (auto lIt = aWords.begin(); lIt != aWords.end(); lIt++)
+    checkRange(lIt->address, 1);
+
+  countRoundTrip();
+  aValues.resize(aWords.size());
+  boost::shared_lock<boost::shared_mutex> lLock(mBufferMutex);
+  for (size_t i = 0; i < aWords.size(); i++) {
+    if ((i == 0) || (aWords.at(i).address != (aWords.at(i - 1).address + 1)))
+      mCounters.blockReads++;
+    mCounters.wordsRead++;
+    aValues.at(i) = loadWord(aWords.at(i).address);
+  }
+}
+
+
+DummyRegisterMap::Counters DummyRegisterMap::getCounters() const
+{
+  Counters lCounters;
+  lCounters.reads = mCounters.reads;
+  lCounters.writes = mCounters.writes;
+  lCounters.blockReads = mCounters.blockReads;
+  lCounters.blockWrites = mCounters.blockWrites;
+  lCounters.wordsRead = mCounters.wordsRead;
+  lCounters.wordsWritten = mCounters.wordsWritten;
+  lCounters.roundTrips = mCounters.roundTrips;
+  return lCounters;
+}
+
+
+void DummyRegisterMap::resetCounters()
+{
+  mCounters.reset();
+}
+
+
+uint32_t DummyRegisterMap::getField(uint32_t aWord, const Register& aRegister)
+{
+  return (aWord & aRegister.mask) >> getShift(aRegister.mask);
+}
+
+
+void DummyRegisterMap::checkRange(uint32_t aAddress, size_t aNrWords) const
+{
+  if ((size_t(aAddress) + aNrWords) > size()) {
+    std::ostringstream lMsg;
+    lMsg << "Register access out of range (address 0x" << std::hex << aAddress << std::dec << ", " << aNrWords << " words)";
+    XCEPT_RAISE(swatch::core::RuntimeError, lMsg.str());
+  }
+}
+
+
+uint32_t DummyRegisterMap::loadWord(uint32_t aAddress) const
+{
+  uint32_t lValue;
+  std::memcpy(&lValue, &mBuffer[aAddress * sizeof(uint32_t)], sizeof(uint32_t));
+  return lValue;
+}
+
+
+void DummyRegisterMap::storeWord(uint32_t aAddress, uint32_t aValue)
+{
+  std::memcpy(&mBuffer[aAddress * sizeof(uint32_t)], &aValue, sizeof(uint32_t));
+}
+
+
+void DummyRegisterMap::countRoundTrip() const
+{
+  mCounters.roundTrips++;
+  if (tRoundTripCount != NULL)
+    (*tRoundTripCount)++;
+}
+
+
+uint32_t DummyRegisterMap::getShift(uint32_t aMask)
+{
+  uint32_t lShift = 0;
+  while ((aMask != 0) && (((aMask >> lShift) & 0x1) == 0))
+    lShift++;
+  return lShift;
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
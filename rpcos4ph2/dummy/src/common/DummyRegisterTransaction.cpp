@@ -0,0 +1,118 @@
+
+#include "rpcos4ph2/dummy/DummyRegisterTransaction.hpp"
+
+
+#include <algorithm>
+#include <sstream>
+
+#include "swatch/core/exception.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+namespace {
+
+bool compareAddresses(const DummyRegisterMap::MaskedWord& aWord1, const DummyRegisterMap::MaskedWord& aWord2)
+{
+  return aWord1.address < aWord2.address;
+}
+
+}
+
+
+DummyRegisterTransaction::DummyRegisterTransaction(DummyRegisterMap& aRegisters) :
+  mRegisters(aRegisters)
+{
+}
+
+
+DummyRegisterTransaction::~DummyRegisterTransaction()
+{
+}
+
+
+void DummyRegisterTransaction::write(uint32_t aAddress, uint32_t aValue)
+{
+  mWords.push_back(DummyRegisterMap::MaskedWord(aAddress, aValue));
+}
+
+
+void DummyRegisterTransaction::write(const DummyRegisterMap::Register& aRegister, uint32_t aValue)
+{
+  mWords.push_back(DummyRegisterMap::MaskedWord(aRegister, aValue));
+}
+
+
+void DummyRegisterTransaction::fill(uint32_t aAddress, size_t aNrWords, uint32_t aValue)
+{
+  mWords.reserve(mWords.size() + aNrWords);
+  for (size_t i = 0; i < aNrWords; i++)
+    mWords.push_back(DummyRegisterMap::MaskedWord(aAddress + i, aValue));
+}
+
+
+void DummyRegisterTransaction::commit(bool aVerify)
+{
+  if (mWords.empty())
+    return;
+
+  coalesce();
+  try {
+    mRegisters.writeBatch(mWords);
+    if (aVerify) {
+      mRegisters.readBatch(mWords, mReadBack);
+      for (size_t i = 0; i < mWords.size(); i++) {
+        const DummyRegisterMap::MaskedWord& lWord = mWords.at(i);
+        if ((mReadBack.at(i) & lWord.mask) != (lWord.value & lWord.mask)) {
+          std::ostringstream lMsg;
+          lMsg << "Read-back verification failed at address 0x" << std::hex << lWord.address << " (wrote 0x" << lWord.value
+               << ", read 0x" << mReadBack.at(i) << ", mask 0x" << lWord.mask << ")";
+          XCEPT_RAISE(swatch::core::RuntimeError, lMsg.str());
+        }
+      }
+    }
+  }
+  catch (...) {
+    mWords.clear();
+    throw;
+  }
+  mWords.clear();
+}
+
+
+void DummyRegisterTransaction::discard()
+{
+  mWords.clear();
+}
+
+
+size_t DummyRegisterTransaction::getNumStagedWrites() const
+{
+  return mWords.size();
+}
+
+
+void DummyRegisterTransaction::coalesce()
+{
+  // Stable sort, so that writes to the same word stay in the order they were staged
+  std::stable_sort(mWords.begin(), mWords.end(), compareAddresses);
+
+  size_t lNrWords = 0;
+  for (size_t i = 0; i < mWords.size(); i++) {
+    const DummyRegisterMap::MaskedWord& lWord = mWords.at(i);
+    if ((lNrWords > 0) && (mWords.at(lNrWords - 1).address == lWord.address)) {
+      DummyRegisterMap::MaskedWord& lMerged = mWords.at(lNrWords - 1);
+      lMerged.value = (lMerged.value & ~lWord.mask) | (lWord.value & lWord.mask);
+      lMerged.mask |= lWord.mask;
+    }
+    else
+      mWords.at(lNrWords++) = lWord;
+  }
+  mWords.erase(mWords.begin() + lNrWords, mWords.end());
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -3,18 +3,24 @@
 
 
 #include "swatch/core/MetricConditions.hpp"
-#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyPortAggregator.hpp"
+#include "rpcos4ph2/dummy/DummyPortMask.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
 
-DummyRxPort::DummyRxPort(const std::string& aId, uint32_t aNumber, DummyProcDriver& aDriver) :
+DummyRxPort::DummyRxPort(const std::string& aId, uint32_t aNumber, size_t aIndex, DummyProcStatusCache& aStatusCache, DummyPortAggregator& aAggregator, DummyPortMask& aPortMask) :
   InputPort(aId),
   mChannelId(aNumber),
-  mDriver(aDriver),
-  mWarningSign(registerMetric<bool>("warningSign"))
+  mIndex(aIndex),
+  mStatusCache(aStatusCache),
+  mAggregator(aAggregator),
+  mPortMask(aPortMask),
+  mWarningSign(registerMetric<bool>("warningSign")),
+  mErrorCriteria(0)
 {
   setWarningCondition<>(mWarningSign, swatch::core::EqualCondition<bool>(true));
 }
@@ -25,14 +31,61 @@ DummyRxPort::~DummyRxPort()
 }
 
 
+size_t DummyRxPort::getIndex() const
+{
+  return mIndex;
+}
+
+
+bool DummyRxPort::isDirty() const
+{
+  return mChangeTracker.isDirty();
+}
+
+
+DummyRefreshTimer& DummyRxPort::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+
 void DummyRxPort::retrieveMetricValues()
 {
-  DummyProcDriver::RxPortStatus lStatus = mDriver.getRxPortStatus(mChannelId);
+  // Mask changes are applied to the totals by comparing with the aggregator's slot, since the mask bitset may
+  // already have been updated (e.g. by DummyProcessor::updatePortMask in a command)
+  const bool lIsMasked = isMasked();
+  mPortMask.setMasked(mIndex, lIsMasked);
+  mAggregator.setMasked(mIndex, lIsMasked);
+
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyProcDriver::RxPortStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getRxPortStatus(mChannelId) : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus) {
+    mAggregator.setUnknown(mIndex);
+    return;
+  }
+  const bool lStatusChanged = mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mMetricIsLocked, lStatus->isLocked);
+  setMetricValue<>(mMetricIsAligned, lStatus->isAligned);
+  setMetricValue<>(mMetricCRCErrors, lStatus->crcErrCount);
+  setMetricValue<>(mWarningSign, lStatus->warningSign);
+
+  // In error under the same conditions as InputPort's error conditions (not locked, not aligned, or CRC errors), but
+  // only counting the metrics whose monitoring is enabled, as for the port's status flag
+  const bool lLockedCounts = (mMetricIsLocked.getMonitoringStatus() == swatch::core::monitoring::kEnabled);
+  const bool lAlignedCounts = (mMetricIsAligned.getMonitoringStatus() == swatch::core::monitoring::kEnabled);
+  const bool lCRCErrorsCount = (mMetricCRCErrors.getMonitoringStatus() == swatch::core::monitoring::kEnabled);
+  const uint32_t lErrorCriteria = (lLockedCounts ? 0x1 : 0x0) | (lAlignedCounts ? 0x2 : 0x0) | (lCRCErrorsCount ? 0x4 : 0x0);
+  const bool lCriteriaChanged = (lErrorCriteria != mErrorCriteria);
+  mErrorCriteria = lErrorCriteria;
 
-  setMetricValue<>(mMetricIsLocked, lStatus.isLocked);
-  setMetricValue<>(mMetricIsAligned, lStatus.isAligned);
-  setMetricValue<>(mMetricCRCErrors, lStatus.crcErrCount);
-  setMetricValue<>(mWarningSign, lStatus.warningSign);
+  // Only ports whose values or error criteria changed need to be re-applied to the totals
+  if (lStatusChanged || lCriteriaChanged) {
+    const bool lIsInError = (lLockedCounts && !lStatus->isLocked) || (lAlignedCounts && !lStatus->isAligned) || (lCRCErrorsCount && (lStatus->crcErrCount > 0));
+    mAggregator.update(mIndex, lStatus->crcErrCount, lIsInError);
+  }
 }
 
 
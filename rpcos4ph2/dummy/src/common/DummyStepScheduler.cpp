@@ -0,0 +1,111 @@
+
+
+#include "rpcos4ph2/dummy/DummyStepScheduler.hpp"
+
+
+#include <algorithm>
+#include <exception>
+
+#include "boost/bind.hpp"
+
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+bool DummyStepScheduler::IsLater::operator()(const Task& aTask1, const Task& aTask2) const
+{
+  if (aTask1.time != aTask2.time)
+    return aTask1.time > aTask2.time;
+  return aTask1.sequence > aTask2.sequence;
+}
+
+
+DummyStepScheduler::DummyStepScheduler(size_t aNumThreads) :
+  mNextSequence(0),
+  mStopping(false)
+{
+  for (size_t i = 0; i < aNumThreads; i++)
+    mThreads.create_thread(boost::bind(&DummyStepScheduler::runWorker, this));
+}
+
+
+DummyStepScheduler::~DummyStepScheduler()
+{
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    mStopping = true;
+  }
+  mCondition.notify_all();
+  mThreads.join_all();
+}
+
+
+DummyStepScheduler& DummyStepScheduler::get()
+{
+  static DummyStepScheduler lScheduler(std::max<size_t>(boost::thread::hardware_concurrency(), 2));
+  return lScheduler;
+}
+
+
+void DummyStepScheduler::post(const boost::function<void ()>& aTask)
+{
+  postAt(boost::chrono::steady_clock::now(), aTask);
+}
+
+
+void DummyStepScheduler::postAt(const boost::chrono::steady_clock::time_point& aTime, const boost::function<void ()>& aTask)
+{
+  {
+    boost::lock_guard<boost::mutex> lGuard(mMutex);
+    Task lTask;
+    lTask.time = aTime;
+    lTask.sequence = mNextSequence++;
+    lTask.function = aTask;
+    mTasks.push(lTask);
+  }
+  // Every thread is woken, since a thread that's waiting for a later task must re-check the earliest due time
+  mCondition.notify_all();
+}
+
+
+size_t DummyStepScheduler::getNumThreads() const
+{
+  return mThreads.size();
+}
+
+
+void DummyStepScheduler::runWorker()
+{
+  boost::unique_lock<boost::mutex> lLock(mMutex);
+  while (!mStopping) {
+    if (mTasks.empty()) {
+      mCondition.wait(lLock);
+      continue;
+    }
+    if (mTasks.top().time > boost::chrono::steady_clock::now()) {
+      const boost::chrono::steady_clock::time_point lTime = mTasks.top().time;
+      mCondition.wait_until(lLock, lTime);
+      continue;
+    }
+
+    const boost::function<void ()> lFunction = mTasks.top().function;
+    mTasks.pop();
+
+    lLock.unlock();
+    try {
+      lFunction();
+    }
+    catch (const std::exception& lException) {
+      LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Command step failed: " << lException.what());
+    }
+    lLock.lock();
+  }
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -1,12 +1,31 @@
 
 #include "rpcos4ph2/dummy/DummySystem.hpp"
 
+#include <algorithm>
+#include <sstream>
+
+#include "boost/bind.hpp"
+#include "boost/thread/thread.hpp"
+
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
+
+#include "xdata/UnsignedInteger.h"
+
 #include "swatch/core/Factory.hpp"
+#include "swatch/action/GateKeeper.hpp"
 #include "swatch/action/SystemStateMachine.hpp"
 #include "swatch/processor/Processor.hpp"
 #include "swatch/processor/PortCollection.hpp"
 #include "swatch/processor/Port.hpp"
 #include "swatch/dtm/DaqTTCManager.hpp"
+#include "rpcos4ph2/dummy/DummyAMC13Manager.hpp"
+#include "rpcos4ph2/dummy/DummyAMC13StatusCache.hpp"
+#include "rpcos4ph2/dummy/DummyBoardBuilder.hpp"
+#include "rpcos4ph2/dummy/DummyMonitoringSweep.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
+#include "rpcos4ph2/dummy/DummyProcessor.hpp"
+#include "rpcos4ph2/dummy/DummyTransitionAnalysis.hpp"
 #include "rpcos4ph2/dummy/utilities.hpp"
 
 SWATCH_REGISTER_CLASS(rpcos4ph2::dummy::DummySystem)
@@ -16,8 +35,51 @@ namespace rpcos4ph2
     namespace dummy
     {
 
-        DummySystem::DummySystem(const swatch::core::AbstractStub &aStub) : swatch::system::System(aStub)
+        namespace
+        {
+            //! Returns the value of an unsigned integer parameter from the gatekeeper, or aDefault if it's not set or isn't an unsigned integer
+            size_t readUnsignedParameter(const swatch::action::GateKeeper &aGateKeeper, const std::vector<std::string> &aContexts, const std::string &aId, size_t aDefault)
+            {
+                const swatch::action::GateKeeper::Parameter_t lParam = aGateKeeper.get("", "", aId, aContexts);
+                if (!lParam)
+                    return aDefault;
+
+                const xdata::UnsignedInteger *lValue = dynamic_cast<const xdata::UnsignedInteger *>(lParam.get());
+                if (lValue == NULL)
+                {
+                    LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Parameter '" << aId << "' isn't an unsigned integer; ignored");
+                    return aDefault;
+                }
+                return lValue->value_;
+            }
+
+            //! Returns the given percentile (0 to 100) of the latencies in milliseconds; reorders the latencies
+            float calculatePercentile(std::vector<boost::chrono::microseconds> &aLatencies, size_t aPercentile)
+            {
+                if (aLatencies.empty())
+                    return 0.0;
+
+                const size_t lIndex = std::min(aLatencies.size() - 1, (aLatencies.size() * aPercentile) / 100);
+                std::nth_element(aLatencies.begin(), aLatencies.begin() + lIndex, aLatencies.end());
+                return float(aLatencies.at(lIndex).count()) / 1000;
+            }
+        } // anonymous namespace
+
+        // Boards' components are built in parallel, on one thread per core. N.B. The gatekeeper isn't available until after the
+        // system has been built, so the number of threads can't be a configuration parameter
+        DummySystem::DummySystem(const swatch::core::AbstractStub &aStub) : DummyBoardBuilder::Scope(aStub, boost::thread::hardware_concurrency()),
+                                                                            swatch::system::System(aStub),
+                                                                            mMonitoringThreads(std::max<size_t>(boost::thread::hardware_concurrency(), 1)),
+                                                                            mMonitoringDeadline(2000),
+                                                                            mMetricSweepTime(registerMetric<float>("monitoringSweepTime")),
+                                                                            mMetricBoardLatencyMedian(registerMetric<float>("boardMonitoringLatencyMedian")),
+                                                                            mMetricBoardLatency90thPercentile(registerMetric<float>("boardMonitoringLatency90thPercentile")),
+                                                                            mMetricBoardLatencyMax(registerMetric<float>("boardMonitoringLatencyMax")),
+                                                                            mMetricBoardsOverdue(registerMetric<uint32_t>("boardsOverdue"))
         {
+            // 0) Drop any prebuilt components that weren't adopted by a board (the scope also drops them if a board throws)
+            DummyBoardBuilder::clear();
+
             // 1) Add system-level metrics
             std::vector<swatch::core::AbstractMetric *> lCRCErrorMetrics;
             std::vector<swatch::core::AbstractMetric *> lPortCountMetrics;
@@ -31,7 +93,16 @@ namespace rpcos4ph2
             registerComplexMetric<uint32_t>("totalCRCErrors", lCRCErrorMetrics.begin(), lCRCErrorMetrics.end(), swatch::core::ComplexMetric<uint32_t>::CalculateFunction_t(&sumUpCRCErrors), filterOutDisabledActionables);
             registerComplexMetric<uint32_t>("portsInError", lPortCountMetrics.begin(), lPortCountMetrics.end(), swatch::core::ComplexMetric<uint32_t>::CalculateFunction_t(&sumUpCRCErrors), filterOutDisabledActionables);
 
-            // 2) Define 'run control' FSM transitions
+            setUpMonitoringSweep();
+
+            // 2) Dependencies between boards' transitions, for the critical path reports: boards only depend on the boards in their crate.
+            //    N.B. The transitions below still run with a barrier after each step, since SWATCH's SystemTransition runs them
+            for (auto lProcIt = getProcessors().begin(); lProcIt != getProcessors().end(); lProcIt++)
+                mTransitionGraph.addBoard((*lProcIt)->getId(), (*lProcIt)->getStub().crate);
+            for (auto lDaqTTCIt = getDaqTTCs().begin(); lDaqTTCIt != getDaqTTCs().end(); lDaqTTCIt++)
+                mTransitionGraph.addBoard((*lDaqTTCIt)->getId(), (*lDaqTTCIt)->getStub().crate);
+
+            // 3) Define 'run control' FSM transitions
             typedef swatch::processor::RunControlFSM ProcFSM_t;
             typedef swatch::dtm::RunControlFSM DaqTTCFSM_t;
 
@@ -62,97 +133,143 @@ namespace rpcos4ph2
             fsm.stopFromPaused.add(getDaqTTCs(), DaqTTCFSM_t::kStatePaused, DaqTTCFSM_t::kTrStop)
                 .add(getProcessors(), ProcFSM_t::kStateRunning, ProcFSM_t::kTrStop);
 
-            fsm.setup.registerWarningAnalyser(&analyseSourceOfWarning);
-            fsm.configure.registerWarningAnalyser(&analyseSourceOfWarning);
-            fsm.align.registerWarningAnalyser(&analyseSourceOfWarning);
+            // 4) Each execution of these transitions has its critical path logged once finished (see reportCompletedTransitions)
+            swatch::action::SystemTransition *const lTransitions[] = {&fsm.coldReset, &fsm.setup, &fsm.configure, &fsm.align, &fsm.start, &fsm.pause,
+                                                                      &fsm.resume, &fsm.stopFromAligned, &fsm.stopFromRunning, &fsm.stopFromPaused};
+            for (size_t i = 0; i < (sizeof(lTransitions) / sizeof(lTransitions[0])); i++)
+            {
+                const ReportedTransition lReported = {lTransitions[i], swatch::action::Functionoid::kInitial, 0.0};
+                mReportedTransitions.push_back(lReported);
+            }
+
+            fsm.setup.registerWarningAnalyser(boost::bind(&DummySystem::analyseSourceOfWarning, this, _1));
+            fsm.configure.registerWarningAnalyser(boost::bind(&DummySystem::analyseSourceOfWarning, this, _1));
+            fsm.align.registerWarningAnalyser(boost::bind(&DummySystem::analyseSourceOfWarning, this, _1));
+            fsm.start.registerWarningAnalyser(boost::bind(&DummySystem::analyseSourceOfWarning, this, _1));
 
-            fsm.setup.registerErrorAnalyser(&analyseSourceOfError);
-            fsm.configure.registerErrorAnalyser(&analyseSourceOfError);
-            fsm.align.registerErrorAnalyser(&analyseSourceOfError);
+            fsm.setup.registerErrorAnalyser(boost::bind(&DummySystem::analyseSourceOfError, this, _1));
+            fsm.configure.registerErrorAnalyser(boost::bind(&DummySystem::analyseSourceOfError, this, _1));
+            fsm.align.registerErrorAnalyser(boost::bind(&DummySystem::analyseSourceOfError, this, _1));
+            fsm.start.registerErrorAnalyser(boost::bind(&DummySystem::analyseSourceOfError, this, _1));
         }
 
         DummySystem::~DummySystem()
         {
+            // Boards outlive the system's own members, so must stop using the sweep before it's destroyed
+            for (auto lProcIt = getProcessors().begin(); lProcIt != getProcessors().end(); lProcIt++)
+            {
+                if (DummyProcessor *lProc = dynamic_cast<DummyProcessor *>(*lProcIt))
+                    lProc->getStatusCache().attach(NULL, 0);
+            }
+            for (auto lAMC13It = getDaqTTCs().begin(); lAMC13It != getDaqTTCs().end(); lAMC13It++)
+            {
+                if (DummyAMC13Manager *lAMC13 = dynamic_cast<DummyAMC13Manager *>(*lAMC13It))
+                    lAMC13->getStatusCache().attach(NULL, 0);
+            }
         }
 
-        std::string DummySystem::analyseSourceOfWarning(const swatch::action::SystemTransitionSnapshot &aSystemSnapshot)
+        void DummySystem::engage(const swatch::action::GateKeeper &aGateKeeper)
         {
-            std::vector<std::pair<std::string, std::string>> lOffendingIds;
-            // Loop over steps ...
-            swatch::action::SystemTransitionSnapshot::const_iterator lStepIt;
-            for (lStepIt = aSystemSnapshot.begin(); lStepIt != aSystemSnapshot.end(); lStepIt++)
+            // Monitoring sweep: parameters that aren't in the key keep their current values
+            mMonitoringThreads = std::max<size_t>(readUnsignedParameter(aGateKeeper, getGateKeeperContexts(), "monitoringThreads", mMonitoringThreads), 1);
+            mMonitoringDeadline = boost::chrono::milliseconds(readUnsignedParameter(aGateKeeper, getGateKeeperContexts(), "monitoringDeadline", mMonitoringDeadline.count()));
+            mMonitoringSweep->configure(mMonitoringThreads, mMonitoringDeadline);
+
+            for (auto lProcIt = getProcessors().begin(); lProcIt != getProcessors().end(); lProcIt++)
+            {
+                if (DummyProcessor *lProc = dynamic_cast<DummyProcessor *>(*lProcIt))
+                    lProc->engage(aGateKeeper);
+            }
+            for (auto lAMC13It = getDaqTTCs().begin(); lAMC13It != getDaqTTCs().end(); lAMC13It++)
             {
+                if (DummyAMC13Manager *lAMC13 = dynamic_cast<DummyAMC13Manager *>(*lAMC13It))
+                    lAMC13->engage(aGateKeeper);
+            }
+        }
 
-                // Loop over single-object transitions within a step ...
-                swatch::action::SystemTransitionSnapshot::Step_t::const_iterator lObjectTransitionIt;
-                for (lObjectTransitionIt = lStepIt->begin(); lObjectTransitionIt != lStepIt->end(); lObjectTransitionIt++)
-                {
+        void DummySystem::retrieveMetricValues()
+        {
+            reportCompletedTransitions();
 
-                    // Check that this single-object transition snapshot was executed (i.e. that the board/crate wasn't excluded from run)
-                    if (*lObjectTransitionIt)
-                    {
-                        // Loop over commands within a single-object transition ...
-                        swatch::action::TransitionSnapshot::const_iterator lCommandIt;
-                        for (lCommandIt = (*lObjectTransitionIt)->begin(); lCommandIt != (*lObjectTransitionIt)->end(); lCommandIt++)
-                        {
-                            const swatch::action::CommandSnapshot &lCommand = *lCommandIt;
-
-                            // Basic analysis: Add names of offending commands & boards to the set
-                            if (lCommand.getState() == swatch::action::Functionoid::State::kWarning)
-                                lOffendingIds.push_back(std::make_pair(lCommand.getActionableId(), lCommand.getActionId()));
-                        }
-                    }
+            // The sweeps themselves are run by the boards (see DummyProcStatusCache::startCycle), whichever is updated first in each cycle
+            DummyMonitoringSweep::Result lResult = mMonitoringSweep->getLastResult();
+
+            setMetricValue<float>(mMetricSweepTime, float(lResult.wallTime.count()) / 1000);
+            setMetricValue<float>(mMetricBoardLatencyMedian, calculatePercentile(lResult.latencies, 50));
+            setMetricValue<float>(mMetricBoardLatency90thPercentile, calculatePercentile(lResult.latencies, 90));
+            setMetricValue<float>(mMetricBoardLatencyMax, calculatePercentile(lResult.latencies, 100));
+            setMetricValue<uint32_t>(mMetricBoardsOverdue, lResult.numOverdue);
+        }
+
+        void DummySystem::setUpMonitoringSweep()
+        {
+            mMonitoringSweep.reset(new DummyMonitoringSweep(mMonitoringThreads, mMonitoringDeadline));
+            for (auto lProcIt = getProcessors().begin(); lProcIt != getProcessors().end(); lProcIt++)
+            {
+                if (DummyProcessor *lProc = dynamic_cast<DummyProcessor *>(*lProcIt))
+                {
+                    DummyProcStatusCache &lCache = lProc->getStatusCache();
+                    lCache.attach(mMonitoringSweep.get(), mMonitoringSweep->addBoard(lProc->getId(), boost::bind(&DummyProcStatusCache::prefetch, &lCache), boost::bind(&DummyProcStatusCache::setUnavailable, &lCache, _1)));
                 }
             }
-            std::ostringstream lOutput;
-            lOutput << "Warning is coming from " << lOffendingIds.size() << " boards/commands ... ";
-            for (auto lIt = lOffendingIds.begin(); lIt != lOffendingIds.end(); lIt++)
+            for (auto lAMC13It = getDaqTTCs().begin(); lAMC13It != getDaqTTCs().end(); lAMC13It++)
             {
-                lOutput << lIt->first << ":" << lIt->second;
-                if (lIt != lOffendingIds.end())
-                    lOutput << ", ";
+                if (DummyAMC13Manager *lAMC13 = dynamic_cast<DummyAMC13Manager *>(*lAMC13It))
+                {
+                    DummyAMC13StatusCache &lCache = lAMC13->getStatusCache();
+                    lCache.attach(mMonitoringSweep.get(), mMonitoringSweep->addBoard(lAMC13->getId(), boost::bind(&DummyAMC13StatusCache::prefetch, &lCache), boost::bind(&DummyAMC13StatusCache::setUnavailable, &lCache, _1)));
+                }
             }
+        }
+
+        std::string DummySystem::analyseSourceOfWarning(const swatch::action::SystemTransitionSnapshot &aSystemSnapshot) const
+        {
+            const DummyTransitionAnalysis lAnalysis(aSystemSnapshot);
+            std::ostringstream lOutput;
+            lOutput << "Warning is coming from ";
+            lAnalysis.writeCommands(lOutput, swatch::action::Functionoid::State::kWarning);
+            lOutput << ". " << getCriticalPath(aSystemSnapshot);
             return lOutput.str();
         }
 
-        std::string DummySystem::analyseSourceOfError(const swatch::action::SystemTransitionSnapshot &aSystemSnapshot)
+        std::string DummySystem::analyseSourceOfError(const swatch::action::SystemTransitionSnapshot &aSystemSnapshot) const
         {
-            std::vector<std::pair<std::string, std::string>> lOffendingIds;
-            // Loop over steps ...
-            swatch::action::SystemTransitionSnapshot::const_iterator lStepIt;
-            for (lStepIt = aSystemSnapshot.begin(); lStepIt != aSystemSnapshot.end(); lStepIt++)
+            const DummyTransitionAnalysis lAnalysis(aSystemSnapshot);
+            std::ostringstream lOutput;
+            lOutput << "Error is coming from ";
+            lAnalysis.writeCommands(lOutput, swatch::action::Functionoid::State::kError);
+            if (lAnalysis.getNumCommands(swatch::action::Functionoid::State::kWarning) > 0)
             {
+                lOutput << "; warnings from ";
+                lAnalysis.writeCommands(lOutput, swatch::action::Functionoid::State::kWarning);
+            }
+            lOutput << ". " << getCriticalPath(aSystemSnapshot);
+            return lOutput.str();
+        }
 
-                // Loop over single-object transitions within a step ...
-                swatch::action::SystemTransitionSnapshot::Step_t::const_iterator lObjectTransitionIt;
-                for (lObjectTransitionIt = lStepIt->begin(); lObjectTransitionIt != lStepIt->end(); lObjectTransitionIt++)
-                {
+        std::string DummySystem::getCriticalPath(const swatch::action::SystemTransitionSnapshot &aSystemSnapshot) const
+        {
+            DummyTransitionGraph::Report lReport;
+            mTransitionGraph.analyse(aSystemSnapshot, lReport);
+            return DummyTransitionGraph::format(lReport);
+        }
 
-                    // Check that this single-object transition snapshot was executed (i.e. that the board/crate wasn't excluded from run)
-                    if (*lObjectTransitionIt)
-                    {
-                        // Loop over commands within a single-object transition ...
-                        swatch::action::TransitionSnapshot::const_iterator lCommandIt;
-                        for (lCommandIt = (*lObjectTransitionIt)->begin(); lCommandIt != (*lObjectTransitionIt)->end(); lCommandIt++)
-                        {
-                            const swatch::action::CommandSnapshot &lCommand = *lCommandIt;
-
-                            // Basic analysis: Add names of offending commands & boards to the set
-                            if (lCommand.getState() == swatch::action::Functionoid::State::kError)
-                                lOffendingIds.push_back(std::make_pair(lCommand.getActionableId(), lCommand.getActionId()));
-                        }
-                    }
-                }
-            }
-            std::ostringstream lOutput;
-            lOutput << "Error is coming from " << lOffendingIds.size() << " boards/commands ... ";
-            for (auto lIt = lOffendingIds.begin(); lIt != lOffendingIds.end(); lIt++)
+        void DummySystem::reportCompletedTransitions()
+        {
+            // A transition's snapshot is kept until it next runs, so a new execution is spotted from its state & running time
+            for (auto lIt = mReportedTransitions.begin(); lIt != mReportedTransitions.end(); lIt++)
             {
-                lOutput << lIt->first << ":" << lIt->second;
-                if (lIt != lOffendingIds.end())
-                    lOutput << ", ";
+                const swatch::action::SystemTransitionSnapshot lSnapshot = lIt->transition->getStatus();
+                const swatch::action::Functionoid::State lState = lSnapshot.getState();
+                if ((lState != swatch::action::Functionoid::kDone) && (lState != swatch::action::Functionoid::kWarning) && (lState != swatch::action::Functionoid::kError))
+                    continue;
+                if ((lState == lIt->state) && (lSnapshot.getRunningTime() == lIt->runningTime))
+                    continue;
+
+                lIt->state = lState;
+                lIt->runningTime = lSnapshot.getRunningTime();
+                LOG4CPLUS_INFO(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Transition '" << lSnapshot.getActionId() << "' of system '" << getId() << "': " << getCriticalPath(lSnapshot));
             }
-            return lOutput.str();
         }
 
     } // namespace dummy
@@ -1,6 +1,6 @@
 
 #include "rpcos4ph2/dummy/DummyTTC.hpp"
-#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
 #include "swatch/core/MetricConditions.hpp"
 
 
@@ -8,9 +8,9 @@ namespace rpcos4ph2 {
 namespace dummy {
 
 
-DummyTTC::DummyTTC(DummyProcDriver& aDriver) :
+DummyTTC::DummyTTC(DummyProcStatusCache& aStatusCache) :
   TTCInterface(),
-  mDriver(aDriver),
+  mStatusCache(aStatusCache),
   mWarningSign(registerMetric<bool>("warningSign"))
 {
   setWarningCondition<>(mWarningSign, swatch::core::EqualCondition<bool>(true));
@@ -22,22 +22,40 @@ DummyTTC::~DummyTTC()
 }
 
 
-void DummyTTC::retrieveMetricValues()
+bool DummyTTC::isDirty() const
 {
-  DummyProcDriver::TTCStatus lStatus = mDriver.getTTCStatus();
+  return mChangeTracker.isDirty();
+}
 
-  setMetricValue<>(mMetricL1ACounter, lStatus.eventCounter);
-  setMetricValue<>(mMetricBunchCounter, lStatus.bunchCounter);
-  setMetricValue<>(mMetricOrbitCounter, lStatus.orbitCounter);
 
-  setMetricValue<>(mMetricIsClock40Locked, lStatus.clk40Locked);
-  setMetricValue<>(mMetricHasClock40Stopped, lStatus.clk40Stopped);
-  setMetricValue<>(mMetricIsBC0Locked, lStatus.bc0Locked);
+DummyRefreshTimer& DummyTTC::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
 
-  setMetricValue<>(mMetricSingleBitErrors, lStatus.errSingleBit);
-  setMetricValue<>(mMetricDoubleBitErrors, lStatus.errDoubleBit);
 
-  setMetricValue<>(mWarningSign, lStatus.warningSign);
+void DummyTTC::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyProcDriver::TTCStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getTTCStatus() : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mMetricL1ACounter, lStatus->eventCounter);
+  setMetricValue<>(mMetricBunchCounter, lStatus->bunchCounter);
+  setMetricValue<>(mMetricOrbitCounter, lStatus->orbitCounter);
+
+  setMetricValue<>(mMetricIsClock40Locked, lStatus->clk40Locked);
+  setMetricValue<>(mMetricHasClock40Stopped, lStatus->clk40Stopped);
+  setMetricValue<>(mMetricIsBC0Locked, lStatus->bc0Locked);
+
+  setMetricValue<>(mMetricSingleBitErrors, lStatus->errSingleBit);
+  setMetricValue<>(mMetricDoubleBitErrors, lStatus->errDoubleBit);
+
+  setMetricValue<>(mWarningSign, lStatus->warningSign);
 }
 
 
@@ -0,0 +1,110 @@
+
+#include "rpcos4ph2/dummy/DummyTransitionAnalysis.hpp"
+
+
+#include <iomanip>
+
+#include "swatch/action/SystemStateMachine.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyTransitionAnalysis::DummyTransitionAnalysis(const swatch::action::SystemTransitionSnapshot& aSnapshot) :
+  mNumDone(0),
+  mNumWarning(0),
+  mNumError(0),
+  mTotalCommandTime(0.0)
+{
+  // Loop over steps, then single-object transitions within a step, then commands within a single-object transition
+  for (auto lStepIt = aSnapshot.begin(); lStepIt != aSnapshot.end(); lStepIt++) {
+    for (auto lObjectTransitionIt = lStepIt->begin(); lObjectTransitionIt != lStepIt->end(); lObjectTransitionIt++) {
+      // Check that this single-object transition snapshot was executed (i.e. that the board/crate wasn't excluded from run)
+      if (!*lObjectTransitionIt)
+        continue;
+
+      for (auto lCommandIt = (*lObjectTransitionIt)->begin(); lCommandIt != (*lObjectTransitionIt)->end(); lCommandIt++) {
+        const swatch::action::CommandSnapshot& lCommand = *lCommandIt;
+        mTotalCommandTime += lCommand.getRunningTime();
+        switch (lCommand.getState()) {
+          case swatch::action::Functionoid::State::kDone :
+            mNumDone++;
+            break;
+          case swatch::action::Functionoid::State::kWarning :
+            mNumWarning++;
+            mWarnings.push_back(&lCommand);
+            break;
+          case swatch::action::Functionoid::State::kError :
+            mNumError++;
+            mErrors.push_back(&lCommand);
+            break;
+          default :
+            break;
+        }
+      }
+    }
+  }
+}
+
+
+DummyTransitionAnalysis::~DummyTransitionAnalysis()
+{
+}
+
+
+size_t DummyTransitionAnalysis::getNumCommands(swatch::action::Functionoid::State aState) const
+{
+  switch (aState) {
+    case swatch::action::Functionoid::State::kDone :
+      return mNumDone;
+    case swatch::action::Functionoid::State::kWarning :
+      return mNumWarning;
+    case swatch::action::Functionoid::State::kError :
+      return mNumError;
+    default :
+      return 0;
+  }
+}
+
+
+const std::vector<const swatch::action::CommandSnapshot*>& DummyTransitionAnalysis::getCommands(swatch::action::Functionoid::State aState) const
+{
+  static const std::vector<const swatch::action::CommandSnapshot*> kNone;
+  switch (aState) {
+    case swatch::action::Functionoid::State::kWarning :
+      return mWarnings;
+    case swatch::action::Functionoid::State::kError :
+      return mErrors;
+    default :
+      return kNone;
+  }
+}
+
+
+float DummyTransitionAnalysis::getTotalCommandTime() const
+{
+  return mTotalCommandTime;
+}
+
+
+void DummyTransitionAnalysis::writeCommands(std::ostream& aStream, swatch::action::Functionoid::State aState) const
+{
+  const std::vector<const swatch::action::CommandSnapshot*>& lCommands = getCommands(aState);
+
+  aStream << lCommands.size() << " boards/commands ... ";
+  const std::ios_base::fmtflags lFlags = aStream.flags();
+  const std::streamsize lPrecision = aStream.precision(1);
+  aStream << std::fixed;
+  for (auto lIt = lCommands.begin(); lIt != lCommands.end(); lIt++) {
+    if (lIt != lCommands.begin())
+      aStream << ", ";
+    aStream << (*lIt)->getActionableId() << ":" << (*lIt)->getActionId() << " (" << (*lIt)->getRunningTime() << "s)";
+  }
+  aStream.flags(lFlags);
+  aStream.precision(lPrecision);
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -0,0 +1,135 @@
+
+#include "rpcos4ph2/dummy/DummyTransitionGraph.hpp"
+
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "swatch/action/SystemStateMachine.hpp"
+
+#include "rpcos4ph2/dummy/DummyArena.hpp"
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+DummyTransitionGraph::DummyTransitionGraph()
+{
+}
+
+
+DummyTransitionGraph::~DummyTransitionGraph()
+{
+}
+
+
+void DummyTransitionGraph::addBoard(const std::string& aBoardId, const std::string& aCrateId)
+{
+  mCrates[aBoardId] = aCrateId;
+}
+
+
+void DummyTransitionGraph::analyse(const swatch::action::SystemTransitionSnapshot& aSnapshot, Report& aReport) const
+{
+  // Scratch data lives in this thread's arena, and only refers to the snapshot's IDs; the arena is rewound for each
+  // analysis, so concurrent analyses (e.g. by the analysers and the monitoring thread) don't share it
+  struct ScratchNode {
+    size_t step;
+    const swatch::action::TransitionSnapshot* snapshot;
+    float finishTime;
+    size_t predecessor;
+  };
+  const size_t kNone = size_t(-1);
+
+  thread_local DummyArena tArena;
+  tArena.reset();
+  std::vector<ScratchNode, DummyArenaAllocator<ScratchNode> > lNodes((DummyArenaAllocator<ScratchNode>(tArena)));
+
+  aReport.barrierTime = 0.0;
+  aReport.estimatedDependencyTime = 0.0;
+  aReport.criticalPath.clear();
+
+  size_t lStep = 0;
+  size_t lLastNode = kNone;
+  for (auto lStepIt = aSnapshot.begin(); lStepIt != aSnapshot.end(); lStepIt++, lStep++) {
+    float lSlowestInStep = 0.0;
+    const size_t lStepStart = lNodes.size();
+    for (auto lObjIt = lStepIt->begin(); lObjIt != lStepIt->end(); lObjIt++) {
+      // Boards excluded from the run have no snapshot
+      if (!*lObjIt)
+        continue;
+
+      ScratchNode lNode;
+      lNode.step = lStep;
+      lNode.snapshot = lObjIt->get();
+      const std::string& lBoardId = lNode.snapshot->getActionableId();
+      const float lRunningTime = lNode.snapshot->getRunningTime();
+
+      // Starts once the latest-finishing prerequisite from the earlier steps has finished
+      float lStartTime = 0.0;
+      lNode.predecessor = kNone;
+      for (size_t i = 0; i < lStepStart; i++) {
+        if (dependsOn(lBoardId, lNodes.at(i).snapshot->getActionableId()) && (lNodes.at(i).finishTime > lStartTime)) {
+          lStartTime = lNodes.at(i).finishTime;
+          lNode.predecessor = i;
+        }
+      }
+      lNode.finishTime = lStartTime + lRunningTime;
+
+      lSlowestInStep = std::max(lSlowestInStep, lRunningTime);
+      if ((lLastNode == kNone) || (lNode.finishTime > lNodes.at(lLastNode).finishTime))
+        lLastNode = lNodes.size();
+      lNodes.push_back(lNode);
+    }
+    aReport.barrierTime += lSlowestInStep;
+  }
+
+  if (lLastNode == kNone)
+    return;
+
+  // Only the nodes on the critical path are copied out of the arena
+  aReport.estimatedDependencyTime = lNodes.at(lLastNode).finishTime;
+  for (size_t i = lLastNode; i != kNone; i = lNodes.at(i).predecessor) {
+    Node lNode;
+    lNode.step = lNodes.at(i).step;
+    lNode.boardId = lNodes.at(i).snapshot->getActionableId();
+    lNode.transitionId = lNodes.at(i).snapshot->getActionId();
+    lNode.runningTime = lNodes.at(i).snapshot->getRunningTime();
+    lNode.finishTime = lNodes.at(i).finishTime;
+    aReport.criticalPath.push_back(lNode);
+  }
+  std::reverse(aReport.criticalPath.begin(), aReport.criticalPath.end());
+}
+
+
+std::string DummyTransitionGraph::format(const Report& aReport)
+{
+  std::ostringstream lOutput;
+  lOutput << std::fixed << std::setprecision(1);
+  lOutput << "Took " << aReport.barrierTime << "s with a barrier after each step; critical path would take an estimated " << aReport.estimatedDependencyTime << "s with only per-crate dependencies: ";
+  for (auto lIt = aReport.criticalPath.begin(); lIt != aReport.criticalPath.end(); lIt++) {
+    if (lIt != aReport.criticalPath.begin())
+      lOutput << " -> ";
+    lOutput << lIt->boardId << ":" << lIt->transitionId << " (" << lIt->runningTime << "s)";
+  }
+  return lOutput.str();
+}
+
+
+bool DummyTransitionGraph::dependsOn(const std::string& aBoard, const std::string& aOtherBoard) const
+{
+  if (aBoard == aOtherBoard)
+    return true;
+
+  auto lCrateIt = mCrates.find(aBoard);
+  auto lOtherCrateIt = mCrates.find(aOtherBoard);
+  if ((lCrateIt == mCrates.end()) || (lOtherCrateIt == mCrates.end()) || lCrateIt->second.empty() || lOtherCrateIt->second.empty())
+    return true;
+  return (lCrateIt->second == lOtherCrateIt->second);
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -0,0 +1,341 @@
+
+#include "rpcos4ph2/dummy/DummyTransitionProfiler.hpp"
+
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <set>
+
+
+namespace rpcos4ph2 {
+namespace dummy {
+
+
+namespace {
+
+std::string getStateName(swatch::action::Functionoid::State aState)
+{
+  switch (aState) {
+    case swatch::action::Functionoid::kDone : return "Done";
+    case swatch::action::Functionoid::kWarning : return "Warning";
+    case swatch::action::Functionoid::kError : return "Error";
+    default : return "Unknown";
+  }
+}
+
+void writeJsonString(std::ostream& aStream, const std::string& aString)
+{
+  aStream << '"';
+  for (auto lIt = aString.begin(); lIt != aString.end(); lIt++) {
+    if ((*lIt == '"') || (*lIt == '\\'))
+      aStream << '\\';
+    aStream << *lIt;
+  }
+  aStream << '"';
+}
+
+//! Summary of a board's commands within one transition
+struct BoardSummary {
+  size_t numCommands;
+  int64_t busyTime;
+  int64_t queueingDelay;
+  uint64_t roundTrips;
+  const DummyTransitionProfiler::Record* slowestCommand;
+};
+
+bool compareStartTimes(const DummyTransitionProfiler::Record& aRecord1, const DummyTransitionProfiler::Record& aRecord2)
+{
+  return aRecord1.startTime < aRecord2.startTime;
+}
+
+}
+
+
+const size_t DummyTransitionProfiler::kCapacity = 4096;
+
+
+DummyTransitionProfiler::Scope::Scope(uint32_t aCommandIndex, bool aNested) :
+  mCommandIndex(aCommandIndex),
+  mTransitionIndex(DummyTransitionProfiler::get().getCurrentTransition()),
+  mNested(aNested),
+  mScheduledTime(DummyTransitionProfiler::get().now()),
+  mStartTime(mScheduledTime),
+  mNumRoundTrips(0),
+  mState(swatch::action::Functionoid::kError)
+{
+}
+
+
+DummyTransitionProfiler::Scope::~Scope()
+{
+  DummyTransitionProfiler& lProfiler = DummyTransitionProfiler::get();
+  lProfiler.record(mCommandIndex, mTransitionIndex, mScheduledTime, mStartTime, lProfiler.now(), mState, getNumRoundTrips(), mNested);
+}
+
+
+void DummyTransitionProfiler::Scope::setState(swatch::action::Functionoid::State aState)
+{
+  mState = aState;
+}
+
+
+void DummyTransitionProfiler::Scope::markStarted()
+{
+  mStartTime = DummyTransitionProfiler::get().now();
+}
+
+
+void DummyTransitionProfiler::Scope::addRoundTrips(uint32_t aNumRoundTrips)
+{
+  mNumRoundTrips += aNumRoundTrips;
+}
+
+
+uint32_t DummyTransitionProfiler::Scope::getNumRoundTrips() const
+{
+  return mNumRoundTrips;
+}
+
+
+DummyTransitionProfiler::DummyTransitionProfiler() :
+  mEpoch(boost::chrono::steady_clock::now()),
+  mSlots(new Slot[kCapacity]),
+  mNextRecord(0),
+  mFirstRecord(0),
+  mCurrentTransition(0),
+  mTransitions(1, "")
+{
+  for (size_t i = 0; i < kCapacity; i++)
+    mSlots[i].sequence.store(0);
+}
+
+
+DummyTransitionProfiler::~DummyTransitionProfiler()
+{
+}
+
+
+DummyTransitionProfiler& DummyTransitionProfiler::get()
+{
+  static DummyTransitionProfiler lProfiler;
+  return lProfiler;
+}
+
+
+uint32_t DummyTransitionProfiler::registerCommand(const std::string& aBoardId, const std::string& aCommandId)
+{
+  boost::lock_guard<boost::mutex> lGuard(mCommandsMutex);
+  for (size_t i = 0; i < mCommands.size(); i++) {
+    if ((mCommands.at(i).boardId == aBoardId) && (mCommands.at(i).commandId == aCommandId))
+      return i;
+  }
+
+  CommandInfo lInfo;
+  lInfo.boardId = aBoardId;
+  lInfo.commandId = aCommandId;
+  mCommands.push_back(lInfo);
+  return mCommands.size() - 1;
+}
+
+
+void DummyTransitionProfiler::beginTransition(const std::string& aTransitionId)
+{
+  boost::lock_guard<boost::mutex> lGuard(mCommandsMutex);
+  const std::vector<std::string>::const_iterator lIt = std::find(mTransitions.begin(), mTransitions.end(), aTransitionId);
+  if (lIt == mTransitions.end()) {
+    mTransitions.push_back(aTransitionId);
+    mCurrentTransition.store(mTransitions.size() - 1);
+  }
+  else
+    mCurrentTransition.store(lIt - mTransitions.begin());
+}
+
+
+uint32_t DummyTransitionProfiler::getCurrentTransition() const
+{
+  return mCurrentTransition.load();
+}
+
+
+void DummyTransitionProfiler::record(uint32_t aCommandIndex, uint32_t aTransitionIndex, int64_t aScheduledTime, int64_t aStartTime, int64_t aEndTime, swatch::action::Functionoid::State aState, uint32_t aRoundTrips, bool aNested)
+{
+  const uint64_t lRecord = mNextRecord.fetch_add(1, std::memory_order_relaxed);
+  Slot& lSlot = mSlots[lRecord % kCapacity];
+
+  lSlot.sequence.store(2 * lRecord + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  lSlot.command.store(aCommandIndex, std::memory_order_relaxed);
+  lSlot.transition.store(aTransitionIndex, std::memory_order_relaxed);
+  lSlot.state.store(aState, std::memory_order_relaxed);
+  lSlot.roundTrips.store(aRoundTrips, std::memory_order_relaxed);
+  lSlot.nested.store(aNested, std::memory_order_relaxed);
+  lSlot.scheduledTime.store(aScheduledTime, std::memory_order_relaxed);
+  lSlot.startTime.store(aStartTime, std::memory_order_relaxed);
+  lSlot.endTime.store(aEndTime, std::memory_order_relaxed);
+  lSlot.sequence.store(2 * lRecord + 2, std::memory_order_release);
+}
+
+
+int64_t DummyTransitionProfiler::now() const
+{
+  return boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - mEpoch).count();
+}
+
+
+void DummyTransitionProfiler::getRecords(std::vector<Record>& aRecords) const
+{
+  aRecords.clear();
+
+  const uint64_t lEnd = mNextRecord.load(std::memory_order_acquire);
+  const uint64_t lBegin = std::max<uint64_t>(mFirstRecord.load(std::memory_order_acquire), (lEnd > kCapacity) ? (lEnd - kCapacity) : 0);
+
+  std::vector<Record> lRecords;
+  std::vector<uint32_t> lCommands, lTransitions;
+  for (uint64_t i = lBegin; i < lEnd; i++) {
+    const Slot& lSlot = mSlots[i % kCapacity];
+    const uint64_t lSequence = lSlot.sequence.load(std::memory_order_acquire);
+    if (lSequence != (2 * i + 2))
+      continue;
+
+    Record lRecord;
+    const uint32_t lCommand = lSlot.command.load(std::memory_order_relaxed);
+    const uint32_t lTransition = lSlot.transition.load(std::memory_order_relaxed);
+    lRecord.state = swatch::action::Functionoid::State(lSlot.state.load(std::memory_order_relaxed));
+    lRecord.scheduledTime = lSlot.scheduledTime.load(std::memory_order_relaxed);
+    lRecord.startTime = lSlot.startTime.load(std::memory_order_relaxed);
+    lRecord.endTime = lSlot.endTime.load(std::memory_order_relaxed);
+    lRecord.roundTrips = lSlot.roundTrips.load(std::memory_order_relaxed);
+    lRecord.nested = lSlot.nested.load(std::memory_order_relaxed);
+    lRecord.queueingDelay = std::max<int64_t>(lRecord.startTime - lRecord.scheduledTime, 0);
+
+    // Discard the slot if it was overwritten while being read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (lSlot.sequence.load(std::memory_order_relaxed) != lSequence)
+      continue;
+
+    lRecords.push_back(lRecord);
+    lCommands.push_back(lCommand);
+    lTransitions.push_back(lTransition);
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lGuard(mCommandsMutex);
+    for (size_t i = 0; i < lRecords.size(); i++) {
+      lRecords.at(i).boardId = mCommands.at(lCommands.at(i)).boardId;
+      lRecords.at(i).commandId = mCommands.at(lCommands.at(i)).commandId;
+      lRecords.at(i).transitionId = mTransitions.at(lTransitions.at(i));
+    }
+  }
+
+  std::stable_sort(lRecords.begin(), lRecords.end(), compareStartTimes);
+  aRecords.swap(lRecords);
+}
+
+
+uint64_t DummyTransitionProfiler::getNumRecorded() const
+{
+  return mNextRecord.load() - mFirstRecord.load();
+}
+
+
+void DummyTransitionProfiler::clear()
+{
+  mFirstRecord.store(mNextRecord.load());
+}
+
+
+void DummyTransitionProfiler::writeChromeTrace(std::ostream& aStream) const
+{
+  std::vector<Record> lRecords;
+  getRecords(lRecords);
+
+  // One thread ID (i.e. row) per board, in order of each board's first command
+  std::map<std::string, size_t> lThreadIds;
+  aStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (auto lIt = lRecords.begin(); lIt != lRecords.end(); lIt++) {
+    if (lThreadIds.count(lIt->boardId) > 0)
+      continue;
+    const size_t lThreadId = lThreadIds.size() + 1;
+    lThreadIds[lIt->boardId] = lThreadId;
+
+    aStream << ((lThreadId == 1) ? "\n" : ",\n");
+    aStream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << lThreadId << ",\"args\":{\"name\":";
+    writeJsonString(aStream, lIt->boardId);
+    aStream << "}}";
+  }
+
+  for (auto lIt = lRecords.begin(); lIt != lRecords.end(); lIt++) {
+    aStream << ",\n{\"name\":";
+    writeJsonString(aStream, lIt->commandId);
+    aStream << ",\"cat\":\"command\",\"ph\":\"X\",\"pid\":1,\"tid\":" << lThreadIds[lIt->boardId];
+    aStream << ",\"ts\":" << lIt->startTime << ",\"dur\":" << (lIt->endTime - lIt->startTime);
+    aStream << ",\"args\":{\"transition\":";
+    writeJsonString(aStream, lIt->transitionId);
+    aStream << ",\"state\":\"" << getStateName(lIt->state) << "\",\"queueing_us\":" << lIt->queueingDelay << ",\"round_trips\":" << lIt->roundTrips << ",\"nested\":" << (lIt->nested ? "true" : "false") << "}}";
+  }
+  aStream << "\n]}\n";
+}
+
+
+void DummyTransitionProfiler::writeSummary(std::ostream& aStream) const
+{
+  std::vector<Record> lRecords;
+  getRecords(lRecords);
+
+  // Boards' summaries for each transition, with the transitions in order of their first command
+  std::vector<std::pair<std::string, std::map<std::string, BoardSummary> > > lTransitions;
+  std::set<std::string> lBoardIds;
+  for (auto lIt = lRecords.begin(); lIt != lRecords.end(); lIt++) {
+    auto lTransitionIt = lTransitions.begin();
+    while ((lTransitionIt != lTransitions.end()) && (lTransitionIt->first != lIt->transitionId))
+      lTransitionIt++;
+    if (lTransitionIt == lTransitions.end())
+      lTransitionIt = lTransitions.insert(lTransitions.end(), std::make_pair(lIt->transitionId, std::map<std::string, BoardSummary>()));
+
+    std::map<std::string, BoardSummary>& lBoards = lTransitionIt->second;
+    auto lBoardIt = lBoards.find(lIt->boardId);
+    if (lBoardIt == lBoards.end()) {
+      BoardSummary lSummary = { 0, 0, 0, 0, &*lIt };
+      lBoardIt = lBoards.insert(std::make_pair(lIt->boardId, lSummary)).first;
+    }
+    lBoardIds.insert(lIt->boardId);
+
+    BoardSummary& lSummary = lBoardIt->second;
+    lSummary.numCommands++;
+    lSummary.busyTime += (lIt->endTime - lIt->startTime);
+    lSummary.queueingDelay += lIt->queueingDelay;
+    if (!lIt->nested)
+      lSummary.roundTrips += lIt->roundTrips;
+    if ((lIt->endTime - lIt->startTime) > (lSummary.slowestCommand->endTime - lSummary.slowestCommand->startTime))
+      lSummary.slowestCommand = &*lIt;
+  }
+
+  aStream << std::fixed << std::setprecision(3);
+  aStream << lRecords.size() << " commands on " << lBoardIds.size() << " boards";
+  const uint64_t lNumRecorded = getNumRecorded();
+  if (lNumRecorded > lRecords.size())
+    aStream << " (" << (lNumRecorded - lRecords.size()) << " older commands overwritten)";
+  for (auto lTransitionIt = lTransitions.begin(); lTransitionIt != lTransitions.end(); lTransitionIt++) {
+    // Round-trips to all boards in the transition
+    size_t lNumCommands = 0;
+    uint64_t lRoundTrips = 0;
+    for (auto lIt = lTransitionIt->second.begin(); lIt != lTransitionIt->second.end(); lIt++) {
+      lNumCommands += lIt->second.numCommands;
+      lRoundTrips += lIt->second.roundTrips;
+    }
+    aStream << "\n " << (lTransitionIt->first.empty() ? std::string("(outside of transitions)") : "'" + lTransitionIt->first + "'") << ": ";
+    aStream << lNumCommands << " commands on " << lTransitionIt->second.size() << " boards, " << lRoundTrips << " round-trips";
+    for (auto lIt = lTransitionIt->second.begin(); lIt != lTransitionIt->second.end(); lIt++) {
+      const Record& lSlowest = *lIt->second.slowestCommand;
+      aStream << "\n  " << lIt->first << ": " << lIt->second.numCommands << " commands, ";
+      aStream << (lIt->second.busyTime / 1e6) << "s running, " << (lIt->second.queueingDelay / 1e6) << "s queueing, " << lIt->second.roundTrips << " round-trips; ";
+      aStream << "slowest '" << lSlowest.commandId << "' (" << ((lSlowest.endTime - lSlowest.startTime) / 1e6) << "s)";
+    }
+  }
+}
+
+
+} // namespace dummy
+} // namespace rpcos4ph2
@@ -3,17 +3,17 @@
 
 
 #include "swatch/core/MetricConditions.hpp"
-#include "rpcos4ph2/dummy/DummyProcDriver.hpp"
+#include "rpcos4ph2/dummy/DummyProcStatusCache.hpp"
 
 
 namespace rpcos4ph2 {
 namespace dummy {
 
 
-DummyTxPort::DummyTxPort(const std::string& aId, uint32_t aNumber, DummyProcDriver& aDriver) :
+DummyTxPort::DummyTxPort(const std::string& aId, uint32_t aNumber, DummyProcStatusCache& aStatusCache) :
   OutputPort(aId),
   mChannelId(aNumber),
-  mDriver(aDriver),
+  mStatusCache(aStatusCache),
   mWarningSign(registerMetric<bool>("warningSign"))
 {
   setWarningCondition<>(mWarningSign, swatch::core::EqualCondition<bool>(true));
@@ -24,12 +24,30 @@ DummyTxPort::~DummyTxPort()
 }
 
 
-void DummyTxPort::retrieveMetricValues()
+bool DummyTxPort::isDirty() const
 {
-  DummyProcDriver::TxPortStatus lStatus = mDriver.getTxPortStatus(mChannelId);
+  return mChangeTracker.isDirty();
+}
+
 
-  setMetricValue<>(mMetricIsOperating, lStatus.isOperating);
-  setMetricValue<>(mWarningSign, lStatus.warningSign);
+DummyRefreshTimer& DummyTxPort::getRefreshTimer()
+{
+  return mRefreshTimer;
+}
+
+
+void DummyTxPort::retrieveMetricValues()
+{
+  // Values are only re-read from the hardware once per refresh period; in between, the previous values are republished
+  mChangeTracker.beginUpdate();
+  const boost::optional<DummyProcDriver::TxPortStatus> lStatus = (mRefreshTimer.isDue() || !mChangeTracker.hasLastStatus()) ? mStatusCache.getTxPortStatus(mChannelId) : mChangeTracker.getLastStatus();
+  // Not reachable: leave the metrics unset, so that they're marked as unknown
+  if (!lStatus)
+    return;
+  mChangeTracker.update(*lStatus);
+
+  setMetricValue<>(mMetricIsOperating, lStatus->isOperating);
+  setMetricValue<>(mWarningSign, lStatus->warningSign);
 }
 
 
@@ -3,14 +3,25 @@
 
 
 // Standard headers
+#include <unistd.h>
+
 #include <cstdlib>
+#include <fstream>
+
+// log4cplus headers
+#include "log4cplus/logger.h"
+#include "log4cplus/loggingmacros.h"
 
 // SWATCH headers
 #include "swatch/action/ActionableObject.hpp"
+#include "swatch/action/GateKeeper.hpp"
 #include "swatch/core/MonitorableObject.hpp"
 #include "swatch/core/MetricSnapshot.hpp"
 #include "swatch/processor/Port.hpp"
 
+// XDAQ headers
+#include "xdata/Boolean.h"
+
 
 namespace rpcos4ph2 {
 namespace dummy {
@@ -28,35 +39,71 @@ bool filterOutDisabledActionables(const swatch::core::MonitorableObject& aObj)
 }
 
 
-const uint32_t* sumUpCRCErrors(const std::vector<swatch::core::MetricSnapshot>& aSnapshots)
+bool calculateSum(const std::vector<swatch::core::MetricSnapshot>& aSnapshots, uint32_t& aSum)
 {
   uint32_t lResult = 0;
-//  std::cout << "> sumUpCRCErrors: " << aSnapshots.size() << " snapshots received"<< std::endl;
   for (auto lIt=aSnapshots.begin(); lIt != aSnapshots.end(); lIt++) {
     if (lIt->isValueKnown())
-      (lResult) += lIt->getValue<uint32_t>();
+      lResult += lIt->getValue<uint32_t>();
     else
-      return NULL;
+      return false;
   }
-//  std::cout << "  result: " << lResult << std::endl;
-  return new uint32_t(lResult);
+  aSum = lResult;
+  return true;
 }
 
 
-const uint32_t* countObjectsInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& aSnapshots)
+bool calculateNumberInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& aSnapshots, uint32_t& aCount)
 {
   uint32_t lResult = 0;
-//  std::cout << "> countObjectsInError: " << aSnapshots.size() << " snapshots received" << std::endl;
-
   for (auto lIt=aSnapshots.begin(); lIt != aSnapshots.end(); lIt++) {
     if (lIt->getStatusFlag() == swatch::core::kUnknown)
-      return NULL;
+      return false;
     else if (lIt->getStatusFlag() == swatch::core::kError)
       lResult++;
   }
+  aCount = lResult;
+  return true;
+}
+
+
+const uint32_t* sumUpCRCErrors(const std::vector<swatch::core::MetricSnapshot>& aSnapshots)
+{
+  uint32_t lResult;
+  return calculateSum(aSnapshots, lResult) ? new uint32_t(lResult) : NULL;
+}
 
-//  std::cout << "  result = " << lResult << std::endl;
-  return new uint32_t(lResult);
+
+const uint32_t* countObjectsInError(const std::vector<swatch::core::MonitorableObjectSnapshot>& aSnapshots)
+{
+  uint32_t lResult;
+  return calculateNumberInError(aSnapshots, lResult) ? new uint32_t(lResult) : NULL;
+}
+
+
+size_t getProcessResidentBytes()
+{
+  // 2nd field of /proc/self/statm is the number of resident pages
+  std::ifstream lStatm("/proc/self/statm");
+  size_t lNrTotalPages = 0, lNrResidentPages = 0;
+  if (!(lStatm >> lNrTotalPages >> lNrResidentPages))
+    return 0;
+  return lNrResidentPages * sysconf(_SC_PAGESIZE);
+}
+
+
+bool readBoolParameter(const swatch::action::GateKeeper& aGateKeeper, const std::vector<std::string>& aContexts, const std::string& aId, bool aDefault)
+{
+  const swatch::action::GateKeeper::Parameter_t lParam = aGateKeeper.get("", "", aId, aContexts);
+  if (!lParam)
+    return aDefault;
+
+  const xdata::Boolean* lValue = dynamic_cast<const xdata::Boolean*>(lParam.get());
+  if (lValue == NULL) {
+    LOG4CPLUS_WARN(log4cplus::Logger::getInstance("rpcos4ph2.dummy"), "Parameter '" << aId << "' isn't a boolean; ignored");
+    return aDefault;
+  }
+  return lValue->value_;
 }
 
 